@@ -3,6 +3,64 @@
 #include <cstring>
 #include <cstdlib>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ASK_CRC16_CLMUL
+#include <immintrin.h>
+
+/* Folding constants for the reflected KERMIT polynomial.
+   A 128-bit block holds the message bytes in order, so bit n of the block is the coefficient of x^(127 - n).
+   Moving the block D bits forward in the message multiplies it by x^D. The low 64 bits are reduced
+   with x^(D + 63) mod P and the high 64 bits with x^(D - 1) mod P, the -1 compensates for the
+   one bit shift of the reflected carry-less product. The 16-bit remainders are stored in the
+   top bits of 64-bit words, because the words are reflected too. */
+#define ASK_CRC16_K_191 0xA95D000000000000ull
+#define ASK_CRC16_K_127 0x7EEA000000000000ull
+#define ASK_CRC16_K_575 0x9822000000000000ull
+#define ASK_CRC16_K_511 0x7F90000000000000ull
+
+__attribute__((target("pclmul,sse2")))
+static inline __m128i clmulFold(__m128i block, __m128i constants){
+  return _mm_xor_si128(_mm_clmulepi64_si128(block, constants, 0x00), _mm_clmulepi64_si128(block, constants, 0x11));
+}
+
+/* Folds the data into a single 128-bit block that has the same CRC as the data itself and
+   returns the number of bytes consumed, always a multiple of 16 and at least 64.
+   The crc is xored into the first bytes, which is how fastCRC applies its initial value. */
+__attribute__((target("pclmul,sse2")))
+static size_t clmulReduce(uint16_t crc, const uint8_t* data, size_t length, uint8_t* block){
+  const __m128i k512 = _mm_set_epi64x((long long)ASK_CRC16_K_511, (long long)ASK_CRC16_K_575);
+  const __m128i k128 = _mm_set_epi64x((long long)ASK_CRC16_K_127, (long long)ASK_CRC16_K_191);
+
+  __m128i x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)data), _mm_cvtsi32_si128(crc));
+  __m128i x1 = _mm_loadu_si128((const __m128i*)(data + 16));
+  __m128i x2 = _mm_loadu_si128((const __m128i*)(data + 32));
+  __m128i x3 = _mm_loadu_si128((const __m128i*)(data + 48));
+  size_t i = 64;
+
+  // four independent lanes hide the latency of the multiplier
+  for(; length - i >= 64; i += 64){
+    x0 = _mm_xor_si128(clmulFold(x0, k512), _mm_loadu_si128((const __m128i*)(data + i)));
+    x1 = _mm_xor_si128(clmulFold(x1, k512), _mm_loadu_si128((const __m128i*)(data + i + 16)));
+    x2 = _mm_xor_si128(clmulFold(x2, k512), _mm_loadu_si128((const __m128i*)(data + i + 32)));
+    x3 = _mm_xor_si128(clmulFold(x3, k512), _mm_loadu_si128((const __m128i*)(data + i + 48)));
+  }
+
+  x0 = _mm_xor_si128(clmulFold(x0, k128), x1);
+  x0 = _mm_xor_si128(clmulFold(x0, k128), x2);
+  x0 = _mm_xor_si128(clmulFold(x0, k128), x3);
+  for(; length - i >= 16; i += 16)
+    x0 = _mm_xor_si128(clmulFold(x0, k128), _mm_loadu_si128((const __m128i*)(data + i)));
+
+  _mm_storeu_si128((__m128i*)block, x0);
+  return i;
+}
+
+static bool clmulSupported(){
+  static const bool supported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse2");
+  return supported;
+}
+#endif
+
 CRC16::CRC16(const uint16_t poly, const uint16_t init, const uint16_t xorout, const bool refin, const bool refout, CALC_METHOD calc_method) : 
 poly(poly), init(init), xorout(xorout), refin(refin), refout(refout), calc_method(calc_method){	
     generateLookupTable();
@@ -113,6 +171,26 @@ uint16_t CRC16::fastCRC(uint16_t crc, uint8_t data){
       ^ ((uint16_t)data << 3));
 }
 
+uint16_t CRC16::fastCRC(uint16_t crc, const void* data, size_t length){
+  const uint8_t* bytes = (const uint8_t*)data;
+  size_t i = 0;
+
+#ifdef ASK_CRC16_CLMUL
+  if(length >= 64 && clmulSupported()){
+    uint8_t block[16];
+    i = clmulReduce(crc, bytes, length, block);
+    // the folded block carries the initial value, so its crc starts from 0
+    crc = 0;
+    for(uint8_t j = 0; j < 16; ++j)
+      crc = fastCRC(crc, block[j]);
+  }
+#endif
+
+  for(; i != length; ++i)
+    crc = fastCRC(crc, bytes[i]);
+  return crc;
+}
+
 uint16_t CRC16::sandels(uint16_t crc, uint8_t data){  
   /*
     this function is equivalent to this crc calculator circuit
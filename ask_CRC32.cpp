@@ -0,0 +1,33 @@
+#include "ask_CRC32.h"
+
+// reflected polynomial 0xEDB88320 multiplied by every 4-bit value
+static const uint32_t nibble_table[16] = {
+  0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+  0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+uint32_t CRC32::begin(){
+  return 0xFFFFFFFF;
+}
+
+uint32_t CRC32::update(uint32_t crc, uint8_t data){
+  crc ^= data;
+  crc = (crc >> 4) ^ nibble_table[crc & 0xF];
+  crc = (crc >> 4) ^ nibble_table[crc & 0xF];
+  return crc;
+}
+
+uint32_t CRC32::update(uint32_t crc, const void* data, size_t length){
+  const uint8_t* bytes = (const uint8_t*)data;
+  for(size_t i = 0; i != length; ++i)
+    crc = update(crc, bytes[i]);
+  return crc;
+}
+
+uint32_t CRC32::complete(uint32_t crc){
+  return crc ^ 0xFFFFFFFF;
+}
+
+uint32_t CRC32::compute(const void* data, size_t length){
+  return complete(update(begin(), data, length));
+}
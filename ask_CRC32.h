@@ -0,0 +1,33 @@
+/* General purpose 32-bit CRC (the CRC-32 used by zip, png and ethernet).
+   Used for checksums that cover more data than a single radio frame, like the whole transferred image.
+   The model is fixed: polynomial 0x04C11DB7, init 0xFFFFFFFF, xorout 0xFFFFFFFF, refin and refout.
+   Check value for "123456789" is 0xCBF43926. */
+#ifndef ASK_CRC32_H
+#define ASK_CRC32_H
+#include <stddef.h>
+#include <stdint.h>
+
+/* The calculation uses a 16 entry (64 byte) nibble lookup table, which is a good compromise between
+   the speed of a full 256 entry table and the size of a bitwise implementation on small targets. */
+class CRC32
+{
+public:
+  /* Returns the initial (incomplete) CRC for a new calculation. */
+  static uint32_t begin();
+
+  /* Computes the next (incomplete) CRC based on given crc and data.
+  Requires a call to complete(uint32_t crc) after last input to get the actual CRC. */
+  static uint32_t update(uint32_t crc, uint8_t data);
+
+  /* Computes the next (incomplete) CRC based on given crc and an array of byte data.
+  Can be called any number of times for consecutive parts of the data. */
+  static uint32_t update(uint32_t crc, const void* data, size_t length);
+
+  /* Returns the final CRC from an incomplete CRC. */
+  static uint32_t complete(uint32_t crc);
+
+  /* Computes the final CRC for an array of byte data. */
+  static uint32_t compute(const void* data, size_t length);
+};
+
+#endif
@@ -9,26 +9,48 @@
 // pointer to the receiver for interrupt handler
 static ask_receiver_t* _ask_receiver;
 
+// cpu clock cycle counter for measuring the interrupt handler, DWT cycle counter on Cortex-M3 and up and microsecond ticker elsewhere
+static inline void ask_receiver_start_cycle_counter()
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+static inline uint32_t ask_receiver_cycle_counter()
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+	return DWT->CYCCNT;
+#else
+	return us_ticker_read() * (SystemCoreClock / 1000000);
+#endif
+}
+
 ask_receiver_t::ask_receiver_t()
 {
 	_is_initialized = false;
+	_rx_lanes = 0;
 }
 
 ask_receiver_t::ask_receiver_t(int rx_frequency, PinName rx_pin)
 {
 	_is_initialized = false;
+	_rx_lanes = 0;
 	init(rx_frequency, rx_pin);
 }
 
 ask_receiver_t::ask_receiver_t(int rx_frequency, PinName rx_pin, uint8_t new_rx_address)
 {
 	_is_initialized = false;
+	_rx_lanes = 0;
 	init(rx_frequency, rx_pin, new_rx_address);
 }
 
 ask_receiver_t::ask_receiver_t(int rx_frequency, PinName rx_pin, uint8_t new_rx_address, bool receive_all_packets)
 {
 	_is_initialized = false;
+	_rx_lanes = 0;
 	init(rx_frequency, rx_pin, new_rx_address, receive_all_packets);
 }
 
@@ -55,8 +77,7 @@ bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_addre
 		// if receiver is initialized detach the interrupt handler and disconnect rx pin
 		if (_is_initialized)
 		{
-			this->detach();
-			gpio_init_in(&_rx_pin, NC);
+			_shutdown();
 			_is_initialized = false;
 		}
 		return true;
@@ -79,13 +100,11 @@ bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_addre
 	{
 		// if reinitializing detach the interrupt handler and disconnect rx pin
 		if (_is_initialized)
-		{
-			this->detach();
-			gpio_init_in(&_rx_pin, NC);
-		}
+			_shutdown();
 
 		_kermit = CRC16(0x1021, 0x0000, 0x0000, true, true, FAST_CRC);
 		rx_address = new_rx_address;
+		rx_group_address = ASK_RECEIVER_BROADCAST_ADDRESS;
 
 		// set receiver initialization parameters
 		_rx_frequency = rx_frequency;
@@ -110,11 +129,14 @@ bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_addre
 		_packets_dropped = 0;
 		_bytes_received = 0;
 		_bytes_dropped = 0;
+		_interrupts = 0;
+		_interrupt_cycles = 0;
 
 		// set ring buffer indices to 0
 		_rx_buffer_read_index = 0;
 		_rx_buffer_write_index = 0;
 
+		_rx_lanes = 0;
 		_is_initialized = true;
 
 		// init rx input pin
@@ -123,11 +145,116 @@ bool ask_receiver_t::init(int rx_frequency, PinName rx_pin, uint8_t new_rx_addre
 		// attach the interrupt handler
 		// receiver interrupt frequency needs to be multipled by samples per bit
 
-		this->attach(callback(this,&ask_receiver_t::_rx_interrupt_handler), (1.0f / (float)(rx_frequency * ASK_RECEIVER_SAMPLERS_PER_BIT)));
+		_rx_handler = &ask_receiver_t::_rx_interrupt_handler;
+		ask_receiver_start_cycle_counter();
+		this->attach(callback(this, &ask_receiver_t::_rx_timed_interrupt_handler), (1.0f / (float)(rx_frequency * ASK_RECEIVER_SAMPLERS_PER_BIT)));
 	}
 	return _is_initialized;
 }
 
+#if DEVICE_PORTIN
+bool ask_receiver_t::init(int rx_frequency, PortName rx_port, uint32_t rx_lane_mask, uint8_t new_rx_address, bool receive_all_packets)
+{
+	// shutdown if rx_frequency is 0
+	if (!rx_frequency)
+		return init(0, NC, new_rx_address, receive_all_packets);
+
+	// count the lanes, lanes are numbered from the least significant bit of the mask
+	uint8_t lanes = 0;
+	uint8_t lane_shift[ASK_RECEIVER_MAXIMUM_LANES];
+	for (uint8_t bit = 0; bit != 32; ++bit)
+		if ((rx_lane_mask >> bit) & 1)
+		{
+			if (lanes == ASK_RECEIVER_MAXIMUM_LANES)
+				return false;
+			lane_shift[lanes++] = bit;
+		}
+
+	// fail if no lanes
+	if (!lanes)
+		return false;
+
+	// fail init if invalid frequency
+	if (!is_valid_frequency(rx_frequency))
+		return false;
+
+	if (!_ask_receiver)
+		_ask_receiver = this;
+
+	// this must be THE receiver
+	if (this == _ask_receiver)
+	{
+		// if reinitializing detach the interrupt handler and disconnect rx pin or port
+		if (_is_initialized)
+			_shutdown();
+
+		_kermit = CRC16(0x1021, 0x0000, 0x0000, true, true, FAST_CRC);
+		rx_address = new_rx_address;
+		rx_group_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+
+		// set receiver initialization parameters
+		_rx_frequency = rx_frequency;
+		_rx_pin_name = NC;
+		_rx_port_name = rx_port;
+		_rx_lane_mask = rx_lane_mask;
+
+		_packets_available = 0;
+		_receive_all_packets = receive_all_packets;
+		_rx_active = 0;
+
+		_rx_lanes = lanes;
+		for (uint8_t i = 0; i != lanes; ++i)
+		{
+			_rx_lane_shift[i] = lane_shift[i];
+			_rx_lane[i].last_sample = 0;
+			_rx_lane[i].ramp = 0;
+			_rx_lane[i].integrator = 0;
+			_rx_lane[i].bit_count = 0;
+			_rx_lane[i].bits = 0;
+			_rx_lane[i].received_byte = 0;
+			_rx_lane[i].active = false;
+		}
+		_rx_lanes_ready = 0;
+
+		// if reinitializing do not reinitialize rx entropy
+		if (!_is_initialized)
+			rx_entropy = 0;
+
+		_packets_received = 0;
+		_packets_dropped = 0;
+		_bytes_received = 0;
+		_bytes_dropped = 0;
+		_interrupts = 0;
+		_interrupt_cycles = 0;
+
+		// set ring buffer indices to 0
+		_rx_buffer_read_index = 0;
+		_rx_buffer_write_index = 0;
+
+		_is_initialized = true;
+
+		// init rx input port
+		port_init(&_rx_port, _rx_port_name, (int)_rx_lane_mask, PIN_INPUT);
+
+		// attach the interrupt handler
+		// receiver interrupt frequency needs to be multipled by samples per bit
+		_rx_handler = &ask_receiver_t::_rx_port_interrupt_handler;
+		ask_receiver_start_cycle_counter();
+		this->attach(callback(this, &ask_receiver_t::_rx_timed_interrupt_handler), (1.0f / (float)(rx_frequency * ASK_RECEIVER_SAMPLERS_PER_BIT)));
+	}
+	return _is_initialized;
+}
+#endif
+
+void ask_receiver_t::_shutdown()
+{
+	// detach the interrupt handler and disconnect rx pin, the port needs no disconnecting since it is input
+	this->detach();
+	if (!_rx_lanes)
+		gpio_init_in(&_rx_pin, NC);
+	_rx_lanes = 0;
+}
+
 size_t ask_receiver_t::recv(void* message_buffer, size_t message_buffer_length)
 {
 	uint8_t ingnored[2];
@@ -141,6 +268,82 @@ size_t ask_receiver_t::recv(uint8_t* tx_address, void* message_buffer, size_t me
 }
 
 size_t ask_receiver_t::recv(uint8_t* rx_address, uint8_t* tx_address, void* message_buffer, size_t message_buffer_length)
+{
+	uint8_t ingnored[2];
+	return _recv(rx_address, tx_address, &ingnored[0], &ingnored[1], message_buffer, message_buffer_length);
+}
+
+void ask_receiver_t::recv_large_init(ask_receiver_large_t* large_message, ask_receiver_sink_t sink)
+{
+	large_message->sink = sink;
+	large_message->active = false;
+	large_message->tx_address = ASK_RECEIVER_BROADCAST_ADDRESS;
+	large_message->next_sequence = 0;
+	large_message->total_length = 0;
+	large_message->received_length = 0;
+	large_message->fragments_lost = 0;
+}
+
+bool ask_receiver_t::recv_large(ask_receiver_large_t* large_message)
+{
+	uint8_t fragment[ASK_RECEIVER_FRAGMENT_HEADER_SIZE + ASK_RECEIVER_FRAGMENT_DATA_SIZE];
+	uint8_t fragment_rx_address;
+	uint8_t fragment_tx_address;
+	uint8_t header_id;
+	uint8_t header_flags;
+
+	size_t fragment_length = _recv(&fragment_rx_address, &fragment_tx_address, &header_id, &header_flags, fragment, sizeof(fragment));
+	if (fragment_length < ASK_RECEIVER_FRAGMENT_HEADER_SIZE || !(header_flags & ASK_RECEIVER_FLAG_FRAGMENT))
+		return false;
+
+	uint16_t sequence = (uint16_t)fragment[0] | ((uint16_t)fragment[1] << 8);
+	size_t total_length = (size_t)fragment[2] | ((size_t)fragment[3] << 8) | ((size_t)fragment[4] << 16) | ((size_t)fragment[5] << 24);
+	size_t offset = (size_t)sequence * ASK_RECEIVER_FRAGMENT_DATA_SIZE;
+	size_t data_length = fragment_length - ASK_RECEIVER_FRAGMENT_HEADER_SIZE;
+
+	bool same_message = large_message->active && fragment_tx_address == large_message->tx_address && total_length == large_message->total_length;
+	if (!sequence && !same_message)
+	{
+		// first fragment begins new message
+		large_message->active = true;
+		large_message->tx_address = fragment_tx_address;
+		large_message->next_sequence = 0;
+		large_message->total_length = total_length;
+		large_message->received_length = 0;
+		large_message->fragments_lost = 0;
+	}
+	else if (!same_message)
+	{
+		// the first fragment of this message was missed
+		return false;
+	}
+
+	// repeated fragment, the first fragment of the active message included
+	if (sequence < large_message->next_sequence)
+		return false;
+
+	// fragment that does not fit in the message is corrupted or from incompatible transmitter
+	if (offset + data_length > total_length)
+	{
+		large_message->active = false;
+		return false;
+	}
+
+	large_message->fragments_lost += (size_t)(sequence - large_message->next_sequence);
+	large_message->next_sequence = sequence + 1;
+	large_message->received_length += data_length;
+	if (large_message->sink)
+		large_message->sink(offset, &fragment[ASK_RECEIVER_FRAGMENT_HEADER_SIZE], data_length);
+
+	if (offset + data_length == total_length)
+	{
+		large_message->active = false;
+		return true;
+	}
+	return false;
+}
+
+size_t ask_receiver_t::_recv(uint8_t* rx_address, uint8_t* tx_address, uint8_t* header_id, uint8_t* header_flags, void* message_buffer, size_t message_buffer_length)
 {
 	if (_packets_available)
 	{
@@ -163,8 +366,9 @@ size_t ask_receiver_t::recv(uint8_t* rx_address, uint8_t* tx_address, void* mess
 		// read header from part
 		*tx_address = _read_byte_from_buffer();
 
-		// discard header id and flag parts they are ignored by this program
-		_discard_bytes_from_buffer(2);
+		// read header id and flags parts
+		*header_id = _read_byte_from_buffer();
+		*header_flags = _read_byte_from_buffer();
 
 		// read message data to  buffer given by caller
 		for (uint8_t* i = (uint8_t*)message_buffer, *e = i + message_lenght; i != e; ++i)
@@ -183,6 +387,7 @@ void ask_receiver_t::status(ask_receiver_status_t* current_status)
 	{
 		current_status->rx_frequency = _rx_frequency;
 		current_status->rx_pin = _rx_pin_name;
+		current_status->rx_lanes = _rx_lanes ? (int)_rx_lanes : 1;
 		current_status->rx_address = rx_address;
 		current_status->initialized = true;
 		current_status->receive_all_packets = _receive_all_packets;
@@ -195,12 +400,16 @@ void ask_receiver_t::status(ask_receiver_status_t* current_status)
 		current_status->packets_dropped = _packets_dropped;
 		current_status->bytes_received = _bytes_received;
 		current_status->bytes_dropped = _bytes_dropped;
+		current_status->buffer_free_space = _get_buffer_free_space();
 		current_status->rx_entropy = rx_entropy;
+		current_status->interrupts = _interrupts;
+		current_status->interrupt_cycles = _interrupt_cycles;
 	}
 	else
 	{
 		current_status->rx_frequency = 0;
 		current_status->rx_pin = NC;
+		current_status->rx_lanes = 0;
 		current_status->rx_address = ASK_RECEIVER_BROADCAST_ADDRESS;
 		current_status->initialized = false;
 		current_status->receive_all_packets = false;
@@ -210,7 +419,10 @@ void ask_receiver_t::status(ask_receiver_status_t* current_status)
 		current_status->packets_dropped = 0;
 		current_status->bytes_received = 0;
 		current_status->bytes_dropped = 0;
+		current_status->buffer_free_space = 0;
 		current_status->rx_entropy = ~0;
+		current_status->interrupts = 0;
+		current_status->interrupt_cycles = 0;
 	}
 }
 
@@ -227,6 +439,14 @@ bool ask_receiver_t::is_valid_frequency(int frequency)
 	return valid_frequency;
 }
 
+void ask_receiver_t::_rx_timed_interrupt_handler()
+{
+	uint32_t start = ask_receiver_cycle_counter();
+	(this->*_rx_handler)();
+	_interrupt_cycles += ask_receiver_cycle_counter() - start;
+	_interrupts++;
+}
+
 void ask_receiver_t::_rx_interrupt_handler()
 {
 	uint8_t rx_sample = (uint8_t)gpio_read(&_ask_receiver->_rx_pin);
@@ -279,69 +499,7 @@ void ask_receiver_t::_rx_interrupt_handler()
 
 				// decode next byte from 2 received symbols
 				uint8_t received_byte = (_decode_symbol((uint8_t)(_ask_receiver->_rx_bits & 0x3F)) << 4) | _decode_symbol((uint8_t)(_ask_receiver->_rx_bits >> 6));
-				
-				if (!_ask_receiver->_packet_received)
-				{
-					// first byte contains length of the packet
-
-					if (received_byte < 7 || (size_t)received_byte > _ask_receiver->_get_buffer_free_space())
-					{
-						// if invalid lenght or not enough space in buffer ignore this packet
-						_ask_receiver->_rx_active = 0;
-
-						_ask_receiver->_packets_dropped++;
-						if (received_byte > 6)
-							_ask_receiver->_bytes_dropped += (size_t)received_byte - 7;
-						return;
-					}
-					_ask_receiver->_packet_length = received_byte;
-				}
-				else if (_ask_receiver->_packet_received == 1 && !_ask_receiver->_receive_all_packets)
-				{
-					// ignore the packets that are not send to this receiver
-					if (received_byte != ASK_RECEIVER_BROADCAST_ADDRESS && received_byte != _ask_receiver->rx_address)
-					{
-						_ask_receiver->_rx_active = 0;
-						_ask_receiver->_erase_current_packet();
-						return;
-					}
-				}
-
-				_ask_receiver->_packet_received += 1;
-				if (_ask_receiver->_packet_received < _ask_receiver->_packet_length - 1)
-					_ask_receiver->_packet_crc = _ask_receiver->_kermit.fastCRC(_ask_receiver->_packet_crc, received_byte);// calculate crc for the packet while receiving it
-				else
-					_ask_receiver->_packet_received_crc = (_ask_receiver->_packet_received_crc >> 8) | ((uint16_t)received_byte << 8);// receive crc of the packet
-				
-				// write next byte of the packet to receivers buffer
-				_ask_receiver->_write_byte_to_buffer(received_byte);
-
-				if (_ask_receiver->_packet_received == _ask_receiver->_packet_length)
-				{
-					// the packet is now received
-					// compare crc of the packet to calculated crc if the match the packet is valid
-					// if the packet is valid it will become readable to recv function
-					// if the packet is invalid it is erased
-
-					_ask_receiver->_packet_crc = ~_ask_receiver->_packet_crc;
-					if (_ask_receiver->_packet_crc == _ask_receiver->_packet_received_crc)
-					{
-						_ask_receiver->_packets_received++;
-						_ask_receiver->_bytes_received += (size_t)_ask_receiver->_packet_length - 7;
-
-						_ask_receiver->_packets_available += 1;
-					}
-					else
-					{
-						_ask_receiver->_erase_current_packet();
-
-						_ask_receiver->_packets_dropped++;
-						_ask_receiver->_bytes_dropped += (size_t)_ask_receiver->_packet_length - 7;
-					}
-
-					// stop receiving this packet
-					_ask_receiver->_rx_active = 0;
-				}
+				_ask_receiver->_receive_byte(received_byte);
 			}
 		}
 		else if (_ask_receiver->_rx_bits == ASK_RECEIVER_START_SYMBOL)
@@ -358,6 +516,184 @@ void ask_receiver_t::_rx_interrupt_handler()
 	}
 }
 
+bool ask_receiver_t::_receive_byte(uint8_t received_byte)
+{
+	// returns false when receiving the packet ended, because it is complete or it was dropped
+
+	if (!_packet_received)
+	{
+		// first byte contains length of the packet
+
+		if (received_byte < 7 || (size_t)received_byte > _get_buffer_free_space())
+		{
+			// if invalid lenght or not enough space in buffer ignore this packet
+			_rx_active = 0;
+
+			_packets_dropped++;
+			if (received_byte > 6)
+				_bytes_dropped += (size_t)received_byte - 7;
+			return false;
+		}
+		_packet_length = received_byte;
+	}
+	else if (_packet_received == 1 && !_receive_all_packets)
+	{
+		// ignore the packets that are not send to this receiver
+		if (received_byte != ASK_RECEIVER_BROADCAST_ADDRESS && received_byte != rx_address && received_byte != rx_group_address)
+		{
+			_rx_active = 0;
+			_erase_current_packet();
+			return false;
+		}
+	}
+
+	_packet_received += 1;
+	if (_packet_received < _packet_length - 1)
+		_packet_crc = _kermit.fastCRC(_packet_crc, received_byte);// calculate crc for the packet while receiving it
+	else
+		_packet_received_crc = (_packet_received_crc >> 8) | ((uint16_t)received_byte << 8);// receive crc of the packet
+
+	// write next byte of the packet to receivers buffer
+	_write_byte_to_buffer(received_byte);
+
+	if (_packet_received == _packet_length)
+	{
+		// the packet is now received
+		// compare crc of the packet to calculated crc if the match the packet is valid
+		// if the packet is valid it will become readable to recv function
+		// if the packet is invalid it is erased
+
+		_packet_crc = ~_packet_crc;
+		if (_packet_crc == _packet_received_crc)
+		{
+			_packets_received++;
+			_bytes_received += (size_t)_packet_length - 7;
+
+			_packets_available += 1;
+		}
+		else
+		{
+			_erase_current_packet();
+
+			_packets_dropped++;
+			_bytes_dropped += (size_t)_packet_length - 7;
+		}
+
+		// stop receiving this packet
+		_rx_active = 0;
+		return false;
+	}
+	return true;
+}
+
+#if DEVICE_PORTIN
+void ask_receiver_t::_rx_port_interrupt_handler()
+{
+	ask_receiver_t* receiver = _ask_receiver;
+
+	// sample all lanes with one port read
+	uint32_t rx_port_sample = (uint32_t)port_read(&receiver->_rx_port);
+	uint8_t lanes = receiver->_rx_lanes;
+
+	// rx_entropy is calculated to crc32 of samples of all lanes
+	uint32_t rx_crc = ~receiver->rx_entropy;
+
+	for (uint8_t lane_index = 0; lane_index != lanes; ++lane_index)
+	{
+		ask_receiver_lane_t* lane = &receiver->_rx_lane[lane_index];
+		uint8_t rx_sample = (uint8_t)((rx_port_sample >> receiver->_rx_lane_shift[lane_index]) & 1);
+
+		uint32_t rx_crc_msb = ((uint32_t)rx_sample ^ rx_crc) & 1;
+		rx_crc = (rx_crc_msb << 31) | ((rx_crc >> 1) ^ (0x6DB88320 & (0 - rx_crc_msb)));
+
+		// every lane has its own ramp like the single pin receiver, lanes may have slightly different timing
+		lane->integrator += rx_sample;
+		if (rx_sample != lane->last_sample)
+		{
+			if (lane->ramp < ASK_RECEIVER_RAMP_TRANSITION)
+				lane->ramp += ASK_RECEIVER_RAMP_INCREMENT_RETARD;
+			else
+				lane->ramp += ASK_RECEIVER_RAMP_INCREMENT_ADVANCE;
+			lane->last_sample = rx_sample;
+		}
+		else
+			lane->ramp += ASK_RECEIVER_RAMP_INCREMENT;
+		if (lane->ramp < ASK_RECEIVER_RAMP_LENGTH)
+			continue;
+
+		lane->ramp -= ASK_RECEIVER_RAMP_LENGTH;
+		lane->bits = (uint16_t)(((uint16_t)(lane->integrator > (ASK_RECEIVER_SAMPLERS_PER_BIT / 2)) << 11) | (lane->bits >> 1));
+		lane->integrator = 0;
+
+		if (lane->active)
+		{
+			lane->bit_count += 1;
+			if (lane->bit_count == 12)
+			{
+				lane->bit_count = 0;
+
+				if (receiver->_rx_lanes_ready & (1 << lane_index))
+				{
+					// this lane received next byte before all lanes received the previous one
+					// some lane missed the start symbol or lost bits so the lanes are out of step, drop the packet
+					if (receiver->_rx_active)
+					{
+						receiver->_erase_current_packet();
+						receiver->_packets_dropped++;
+						if (receiver->_packet_received)
+							receiver->_bytes_dropped += (size_t)receiver->_packet_length - 7;
+					}
+					receiver->_stop_lanes();
+					continue;
+				}
+
+				// decode next byte of this lane from 2 received symbols
+				lane->received_byte = (_decode_symbol((uint8_t)(lane->bits & 0x3F)) << 4) | _decode_symbol((uint8_t)(lane->bits >> 6));
+				receiver->_rx_lanes_ready |= (uint8_t)(1 << lane_index);
+			}
+		}
+		else if (lane->bits == ASK_RECEIVER_START_SYMBOL)
+		{
+			// the first lane that receives the start symbol begins the packet
+			lane->active = true;
+			lane->bit_count = 0;
+			if (!receiver->_rx_active)
+			{
+				receiver->_rx_active = 1;
+				receiver->_packet_length = 0;
+				receiver->_packet_received = 0;
+				receiver->_packet_crc = 0xFFFF;
+				receiver->_packet_received_crc = 0;
+			}
+		}
+	}
+
+	receiver->rx_entropy = ~rx_crc;
+
+	// when every lane has received a byte, the bytes are the next bytes of the packet in lane order
+	if (receiver->_rx_lanes_ready == (uint8_t)((1 << lanes) - 1))
+	{
+		receiver->_rx_lanes_ready = 0;
+		for (uint8_t lane_index = 0; lane_index != lanes; ++lane_index)
+			if (!receiver->_receive_byte(receiver->_rx_lane[lane_index].received_byte))
+			{
+				// rest of the bytes are padding after the packet
+				receiver->_stop_lanes();
+				break;
+			}
+	}
+}
+
+void ask_receiver_t::_stop_lanes()
+{
+	// all lanes start waiting for the next start symbol
+	for (uint8_t lane_index = 0; lane_index != _rx_lanes; ++lane_index)
+		_rx_lane[lane_index].active = false;
+	_rx_lanes_ready = 0;
+	_rx_active = 0;
+}
+#endif
+
 uint8_t ask_receiver_t::_decode_symbol(uint8_t _6bit_symbol)
 {
 	static const uint8_t symbol_table[16] = { 0x0D, 0x0E, 0x13, 0x15, 0x16, 0x19, 0x1A, 0x1C, 0x23, 0x25, 0x26, 0x29, 0x2A, 0x2C, 0x32, 0x34 };
@@ -6,6 +6,15 @@
 		Simple ask receiver for Mbed OS.
 		The receiver can be used to communicate with RadioHead library.
 
+	Local modifications
+		Changes made in this project on top of the upstream version above, not part of mbed-os-ask.
+		2026-10-19
+			interrupts and interrupt_cycles members added to ask_receiver_status_t.
+			rx_group_address member variable added.
+			Multi-lane mode added, init overload for GPIO port and rx_lanes member added to ask_receiver_status_t.
+			buffer_free_space member added to ask_receiver_status_t.
+			recv_large and recv_large_init member functions added.
+
 	Version history
 		version 1.4.1 2018-08-01
 			rx_entropy bit mixing improved.
@@ -57,8 +66,19 @@
 #define ASK_RECEIVER_BROADCAST_ADDRESS 0xFF
 #define ASK_RECEIVER_SAMPLERS_PER_BIT 8
 
+// header flag of packets that are fragments of a large message, see send_large of the transmitter
+#define ASK_RECEIVER_FLAG_FRAGMENT 0x01
+#define ASK_RECEIVER_FRAGMENT_HEADER_SIZE 6
+// this needs to be the same as ASK_TRANSMITTER_FRAGMENT_DATA_SIZE of the transmitter
+#ifndef ASK_RECEIVER_FRAGMENT_DATA_SIZE
+#define ASK_RECEIVER_FRAGMENT_DATA_SIZE 50
+#endif
+
 #define ASK_RECEIVER_START_SYMBOL 0xB38
 
+// maximum number of lanes in multi-lane mode
+#define ASK_RECEIVER_MAXIMUM_LANES 8
+
 #define ASK_RECEIVER_RAMP_LENGTH 160
 #define ASK_RECEIVER_RAMP_INCREMENT (ASK_RECEIVER_RAMP_LENGTH / ASK_RECEIVER_SAMPLERS_PER_BIT)
 #define ASK_RECEIVER_RAMP_TRANSITION (ASK_RECEIVER_RAMP_LENGTH / 2)
@@ -70,6 +90,7 @@ typedef struct ask_receiver_status_t
 {
 	int rx_frequency;
 	PinName rx_pin;
+	int rx_lanes;
 	uint8_t rx_address;
 	bool initialized;
 	bool receive_all_packets;
@@ -79,9 +100,39 @@ typedef struct ask_receiver_status_t
 	size_t packets_dropped;
 	size_t bytes_received;
 	size_t bytes_dropped;
+	size_t buffer_free_space;
 	uint32_t rx_entropy;
+	// number of interrupts and cpu clock cycles (SystemCoreClock) spent in the interrupt handler since init, both wrap around
+	uint32_t interrupts;
+	uint32_t interrupt_cycles;
 } ask_receiver_status_t;
 
+// receives fragment data of a large message, offset is the position of the data in the message
+typedef Callback<void(size_t offset, const void* data, size_t length)> ask_receiver_sink_t;
+
+typedef struct ask_receiver_large_t
+{
+	ask_receiver_sink_t sink;
+	bool active;
+	uint8_t tx_address;
+	uint16_t next_sequence;
+	size_t total_length;
+	size_t received_length;
+	size_t fragments_lost;
+} ask_receiver_large_t;
+
+// bit synchronization and symbol decoding state of one lane in multi-lane mode
+typedef struct ask_receiver_lane_t
+{
+	uint8_t last_sample;
+	uint8_t ramp;
+	uint8_t integrator;
+	uint8_t bit_count;
+	uint16_t bits;
+	uint8_t received_byte;
+	bool active;
+} ask_receiver_lane_t;
+
 class ask_receiver_t : public Ticker
 {
 	public :
@@ -158,6 +209,37 @@ class ask_receiver_t : public Ticker
 				If the function succeeds, the return value is true and false on failure.
 		*/
 
+#if DEVICE_PORTIN
+		bool init(int rx_frequency, PortName rx_port, uint32_t rx_lane_mask, uint8_t new_rx_address, bool receive_all_packets);
+		/*
+			Descriptions
+				Re/initializes the receiver object in multi-lane mode.
+				In multi-lane mode every pin of rx_lane_mask is a lane of its own and all lanes are sampled together with one port read every sample.
+				Every lane synchronizes to its own bits and finds its own start symbol, byte n of the packet is received from lane n % lanes.
+				Lanes are numbered from the least significant bit of rx_lane_mask, the transmitter needs to use the same order.
+				If some lane misses the start symbol or loses bits the lanes get out of step and the packet is dropped.
+				Re/initializing receiver object will fail if initialized receiver object already exists.
+				Value of rx_address is set to the new rx address.
+			Parameters
+				rx_frequency
+					The frequency of the receiver. This value is required to be valid frequency or 0, or the function fails.
+					Valid frequencies are 1000, 1250, 2500 and 3125.
+					If this parameter is 0 the receiver is shutdown like by the other init functions.
+				rx_port
+					Mbed OS port name for the port of the lanes.
+				rx_lane_mask
+					Mask of the pins of the port that are used as lanes.
+					The mask needs to have at least one and at most ASK_RECEIVER_MAXIMUM_LANES bits set.
+				new_rx_address
+					rx address for the receiver.
+				receive_all_packets
+					If value of receive_all_packets is false receiver receives only packets that are send to broadcast address or receiver's rx address.
+					If value of receive_all_packets is true receiver receives all packets.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+#endif
+
 		size_t recv(void* message_buffer, size_t message_buffer_length);
 		/*
 			Description
@@ -221,10 +303,45 @@ class ask_receiver_t : public Ticker
 				If no packet is read it returns 0.
 		*/
 
+		static void recv_large_init(ask_receiver_large_t* large_message, ask_receiver_sink_t sink);
+		/*
+			Description
+				Prepares state of a large message for recv_large function.
+				This function does not require initialized receiver.
+			Parameters
+				large_message
+					Pointer to variable that holds the reassembly state of the message.
+				sink
+					Callback that is called with the data of every received fragment.
+			Return
+				No return value.
+		*/
+
+		bool recv_large(ask_receiver_large_t* large_message);
+		/*
+			Description
+				Function reads next packet from receiver's buffer if there are any available packets and reassembles large message send by send_large function of a transmitter.
+				Data of the fragment is passed to the sink of large_message with its offset in the message, the message is never buffered by the receiver.
+				Fragment with sequence number 0 begins new message and fragments are expected in order after it.
+				While a message from the same transmitter with the same total length is active, fragment with sequence number 0 is a repeat and does not restart it.
+				Missing fragments are counted to fragments_lost and their data is never passed to the sink, repeated fragments are ignored.
+				Packets that are not fragments are read and ignored.
+				The receiver does not receive any packets if it is not initialized.
+			Parameters
+				large_message
+					Pointer to variable that holds the reassembly state of the message, initialized by recv_large_init.
+					After the last fragment tx_address is the address of the transmitter, total_length is the length of the message
+					and received_length is the number of bytes passed to the sink. The message is complete if received_length is equal to total_length.
+			Return
+				If function reads the last fragment of a message it returns true, else it returns false.
+		*/
+
 		void status(ask_receiver_status_t* current_status);
 		/*
 			Description
 				Function queries the current status of the receiver.
+				buffer_free_space is the number of bytes that the interrupt handler can still write to receiver's buffer,
+				a packet takes the size of its data and 7 bytes of the buffer until it is read by recv.
 			Parameters
 				current_status
 					Pointer to variable that receives current stutus of the receiver.
@@ -248,6 +365,10 @@ class ask_receiver_t : public Ticker
 		volatile uint8_t rx_address;
 		// Value of rx_address specifies address of the receiver.
 
+		volatile uint8_t rx_group_address;
+		// Value of rx_group_address specifies group address that the receiver receives in addition to its rx address and the broadcast address.
+		// Init functions set it to ASK_RECEIVER_BROADCAST_ADDRESS, which means no group address.
+
 		volatile uint32_t rx_entropy;
 		// Value of rx_entropy is mix of all samples that the receiver reads from rx pin.
 		// This variable is updated rx_frequency * ASK_RECEIVER_SAMPLERS_PER_BIT times every second by the Receiver's interrupt handler, while the receiver initialized.
@@ -257,6 +378,14 @@ class ask_receiver_t : public Ticker
 		//static void _rx_interrupt_handler();
 		//static uint8_t _decode_symbol(uint8_t _6bit_symbol);
 	    void _rx_interrupt_handler();
+		void _rx_timed_interrupt_handler();
+		bool _receive_byte(uint8_t received_byte);
+		void _shutdown();
+#if DEVICE_PORTIN
+		void _rx_port_interrupt_handler();
+		void _stop_lanes();
+#endif
+		size_t _recv(uint8_t* rx_address, uint8_t* tx_address, uint8_t* header_id, uint8_t* header_flags, void* message_buffer, size_t message_buffer_length);
 		uint8_t _decode_symbol(uint8_t _6bit_symbol);
 		size_t _get_buffer_free_space();
 		void _write_byte_to_buffer(uint8_t data);
@@ -287,14 +416,33 @@ class ask_receiver_t : public Ticker
 		volatile size_t _bytes_received;
 		volatile size_t _bytes_dropped;
 
+		// the ticker calls _rx_timed_interrupt_handler that measures the time spent in _rx_handler
+		void (ask_receiver_t::*_rx_handler)();
+		volatile uint32_t _interrupts;
+		volatile uint32_t _interrupt_cycles;
+
 		// input ring buffer
 		volatile size_t _rx_buffer_read_index;
 		volatile size_t _rx_buffer_write_index;
 		volatile uint8_t _rx_buffer[ASK_RECEIVER_BUFFER_SIZE];
 
+		// multi-lane mode, _rx_lanes is 0 when the receiver uses single rx pin
+		uint8_t _rx_lanes;
+#if DEVICE_PORTIN
+		port_t _rx_port;
+		uint8_t _rx_lane_shift[ASK_RECEIVER_MAXIMUM_LANES];
+		ask_receiver_lane_t _rx_lane[ASK_RECEIVER_MAXIMUM_LANES];
+		// lanes that have a byte waiting for the other lanes
+		uint8_t _rx_lanes_ready;
+#endif
+
 		// receiver initialization parameters
 		int _rx_frequency;
 		PinName _rx_pin_name;
+#if DEVICE_PORTIN
+		PortName _rx_port_name;
+		uint32_t _rx_lane_mask;
+#endif
 
        
 		// No copying object of this type!
@@ -9,6 +9,24 @@
 // KJ puukko
 //static ask_transmitter_t* _ask_transmitter;
 
+// cpu clock cycle counter for measuring the interrupt handler, DWT cycle counter on Cortex-M3 and up and microsecond ticker elsewhere
+static inline void ask_transmitter_start_cycle_counter()
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+static inline uint32_t ask_transmitter_cycle_counter()
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+	return DWT->CYCCNT;
+#else
+	return us_ticker_read() * (SystemCoreClock / 1000000);
+#endif
+}
+
 #ifdef ASK_TRANSMITTER_WIRED_DEBUG_MODE
 // when the transmitter is not sending data tx will have no pull on wired debug mode
 static bool _tx_no_pull;
@@ -17,17 +35,20 @@ static bool _tx_no_pull;
 ask_transmitter_t::ask_transmitter_t()
 {
 	_is_initialized = false;
+	_tx_lanes = 0;
 }
 
 ask_transmitter_t::ask_transmitter_t(int tx_frequency, PinName tx_pin)
 {
 	_is_initialized = false;
+	_tx_lanes = 0;
 	init(tx_frequency, tx_pin);
 }
 
 ask_transmitter_t::ask_transmitter_t(int tx_frequency, PinName tx_pin, uint8_t new_tx_address)
 {
 	_is_initialized = false;
+	_tx_lanes = 0;
 	init(tx_frequency, tx_pin, new_tx_address);
 }
 
@@ -49,19 +70,8 @@ bool ask_transmitter_t::init(int tx_frequency, PinName tx_pin, uint8_t new_tx_ad
 		// if transmitter is initialized detach the interrupt handler and disconnect tx pin
 		if (_is_initialized)
 		{
-#ifdef ASK_TRANSMITTER_WIRED_DEBUG_MODE
-			_tx_timer.detach();
-			core_util_critical_section_enter();
-			gpio_dir(&_tx_pin, PIN_INPUT);
-			core_util_critical_section_exit();
-			gpio_init_inout(&_tx_pin, NC, PIN_INPUT, PullNone, 0);
+			_shutdown();
 			_is_initialized = false;
-			_tx_no_pull = true;
-#else
-			this->detach();
-			gpio_init_out_ex(&_tx_pin, NC, 0);
-			_is_initialized = false;
-#endif
 		}
 		return true;
 	}
@@ -83,19 +93,7 @@ bool ask_transmitter_t::init(int tx_frequency, PinName tx_pin, uint8_t new_tx_ad
 	{
 		// if reinitializing detach the interrupt handler and disconnect tx pin
 		if (_is_initialized)
-		{
-#ifdef ASK_TRANSMITTER_WIRED_DEBUG_MODE
-			_tx_timer.detach();
-			core_util_critical_section_enter();
-			gpio_dir(&_tx_pin, PIN_INPUT);
-			core_util_critical_section_exit();
-			gpio_init_inout(&_tx_pin, NC, PIN_INPUT, PullNone, 0);
-			_tx_no_pull = true;
-#else
-			this->detach();
-			gpio_init_out_ex(&_tx_pin, NC, 0);
-#endif
-		}
+			_shutdown();
 
 		_kermit = CRC16(0x1021, 0x0000, 0x0000, true, true, FAST_CRC);
 		tx_address = new_tx_address;
@@ -106,12 +104,15 @@ bool ask_transmitter_t::init(int tx_frequency, PinName tx_pin, uint8_t new_tx_ad
 
 		_packets_send = 0;
 		_bytes_send = 0;
+		_interrupts = 0;
+		_interrupt_cycles = 0;
 
 		// set ring buffer indices to 0
 		_tx_output_symbol_bit_index = 0;
 		_tx_buffer_read_index = 0;
 		_tx_buffer_write_index = 0;
 
+		_tx_lanes = 0;
 		_is_initialized = true;
 
 		// init tx output pin
@@ -124,21 +125,175 @@ bool ask_transmitter_t::init(int tx_frequency, PinName tx_pin, uint8_t new_tx_ad
 #endif
 		
 		// attach the interrupt handler
-		this->attach(callback(this,&ask_transmitter_t::_tx_interrupt_handler), (1.0f / (float)tx_frequency));
+		_tx_handler = &ask_transmitter_t::_tx_interrupt_handler;
+		ask_transmitter_start_cycle_counter();
+		this->attach(callback(this, &ask_transmitter_t::_tx_timed_interrupt_handler), (1.0f / (float)tx_frequency));
 	}
 	return _is_initialized;
 }
 
+#if DEVICE_PORTOUT
+bool ask_transmitter_t::init(int tx_frequency, PortName tx_port, uint32_t tx_lane_mask, uint8_t new_tx_address)
+{
+	// shutdown if tx_frequency is 0
+	if (!tx_frequency)
+		return init(0, NC, new_tx_address);
+
+	// count the lanes, lanes are numbered from the least significant bit of the mask
+	uint8_t lanes = 0;
+	uint8_t lane_shift[ASK_TRANSMITTER_MAXIMUM_LANES];
+	for (uint8_t bit = 0; bit != 32; ++bit)
+		if ((tx_lane_mask >> bit) & 1)
+		{
+			if (lanes == ASK_TRANSMITTER_MAXIMUM_LANES)
+				return false;
+			lane_shift[lanes++] = bit;
+		}
+
+	// fail if no lanes
+	if (!lanes)
+		return false;
+
+	// fail init if invalid frequency
+	if (!is_valid_frequency(tx_frequency))
+		return false;
+
+	if (!_ask_transmitter)
+		_ask_transmitter = this;
+
+	// this must be THE transmitter
+	if (this == _ask_transmitter)
+	{
+		// if reinitializing detach the interrupt handler and disconnect tx pin or port
+		if (_is_initialized)
+			_shutdown();
+
+		_kermit = CRC16(0x1021, 0x0000, 0x0000, true, true, FAST_CRC);
+		tx_address = new_tx_address;
+
+		// set transmitter initialization parameters
+		_tx_frequency = tx_frequency;
+		_tx_pin_name = NC;
+		_tx_port_name = tx_port;
+		_tx_lane_mask = tx_lane_mask;
+
+		_packets_send = 0;
+		_bytes_send = 0;
+		_interrupts = 0;
+		_interrupt_cycles = 0;
+
+		// set ring buffer indices to 0
+		_tx_output_symbol_bit_index = 0;
+		_tx_buffer_read_index = 0;
+		_tx_buffer_write_index = 0;
+
+		_tx_lanes = lanes;
+		for (uint8_t i = 0; i != lanes; ++i)
+			_tx_lane_shift[i] = lane_shift[i];
+
+		_is_initialized = true;
+
+		// init tx output port, all lanes low
+		port_init(&_tx_port, _tx_port_name, (int)_tx_lane_mask, PIN_OUTPUT);
+		port_write(&_tx_port, 0);
+
+		// attach the interrupt handler
+		_tx_handler = &ask_transmitter_t::_tx_port_interrupt_handler;
+		ask_transmitter_start_cycle_counter();
+		this->attach(callback(this, &ask_transmitter_t::_tx_timed_interrupt_handler), (1.0f / (float)tx_frequency));
+	}
+	return _is_initialized;
+}
+#endif
+
+void ask_transmitter_t::_shutdown()
+{
+	// detach the interrupt handler and disconnect tx pin or port
+#if DEVICE_PORTOUT
+	if (_tx_lanes)
+	{
+		this->detach();
+		port_write(&_tx_port, 0);
+		port_dir(&_tx_port, PIN_INPUT);
+		_tx_lanes = 0;
+		return;
+	}
+#endif
+#ifdef ASK_TRANSMITTER_WIRED_DEBUG_MODE
+	_tx_timer.detach();
+	core_util_critical_section_enter();
+	gpio_dir(&_tx_pin, PIN_INPUT);
+	core_util_critical_section_exit();
+	gpio_init_inout(&_tx_pin, NC, PIN_INPUT, PullNone, 0);
+	_tx_no_pull = true;
+#else
+	this->detach();
+	gpio_init_out_ex(&_tx_pin, NC, 0);
+#endif
+}
+
 bool ask_transmitter_t::send(uint8_t rx_address, const void* message_data, size_t message_byte_length)
+{
+	return _send(rx_address, 0, 0, message_data, message_byte_length);
+}
+
+bool ask_transmitter_t::send(const void* message_data, size_t message_byte_length)
+{
+	return send(ASK_TRANSMITTER_BROADCAST_ADDRESS, message_data, message_byte_length);
+}
+
+bool ask_transmitter_t::send_large(uint8_t rx_address, const void* message_data, size_t message_byte_length)
+{
+	if (message_byte_length > ASK_TRANSMITTER_MAXIMUM_LARGE_MESSAGE_SIZE || !_is_initialized)
+		return false;
+
+	uint8_t fragment[ASK_TRANSMITTER_FRAGMENT_HEADER_SIZE + ASK_TRANSMITTER_FRAGMENT_DATA_SIZE];
+
+	// total length is the same in every fragment
+	fragment[2] = (uint8_t)(message_byte_length & 0xFF);
+	fragment[3] = (uint8_t)((message_byte_length >> 8) & 0xFF);
+	fragment[4] = (uint8_t)((message_byte_length >> 16) & 0xFF);
+	fragment[5] = (uint8_t)((message_byte_length >> 24) & 0xFF);
+
+	// empty message is send as one empty fragment
+	size_t offset = 0;
+	uint16_t sequence = 0;
+	do
+	{
+		size_t fragment_data_length = message_byte_length - offset;
+		if (fragment_data_length > ASK_TRANSMITTER_FRAGMENT_DATA_SIZE)
+			fragment_data_length = ASK_TRANSMITTER_FRAGMENT_DATA_SIZE;
+
+		fragment[0] = (uint8_t)(sequence & 0xFF);
+		fragment[1] = (uint8_t)(sequence >> 8);
+		for (size_t i = 0; i != fragment_data_length; ++i)
+			fragment[ASK_TRANSMITTER_FRAGMENT_HEADER_SIZE + i] = *(const uint8_t*)((uintptr_t)message_data + offset + i);
+
+		if (!_send(rx_address, 0, ASK_TRANSMITTER_FLAG_FRAGMENT, fragment, ASK_TRANSMITTER_FRAGMENT_HEADER_SIZE + fragment_data_length))
+			return false;
+
+		offset += fragment_data_length;
+		++sequence;
+	} while (offset != message_byte_length);
+
+	return true;
+}
+
+bool ask_transmitter_t::_send(uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const void* message_data, size_t message_byte_length)
 {
 	static const uint8_t preamble_and_start_symbol[8] = { 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x38, 0x2C };
 
 	if (message_byte_length > ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE || !_is_initialized)
 		return false;
 
+#if DEVICE_PORTOUT
+	if (_tx_lanes)
+		return _send_lanes(rx_address, header_id, header_flags, message_data, message_byte_length);
+#endif
+
 	// the data after the start symbol begins with length of the packet, header rx address, header tx address, header id, header flags
 	// lenght of the packet is (1 byte lenght + 1 byte rx address + 1 byte tx ddress + 1 byte id + 1 byte flags + n bytes message + 2 bytes crc)
-	uint8_t length_and_header[5] = { (uint8_t)(7 + message_byte_length), rx_address, tx_address, 0, 0, };
+	uint8_t length_and_header[5] = { (uint8_t)(7 + message_byte_length), rx_address, tx_address, header_id, header_flags, };
 
 	// crc init is 0xFFFF
 	uint16_t crc = 0xFFFF;
@@ -187,10 +342,64 @@ bool ask_transmitter_t::send(uint8_t rx_address, const void* message_data, size_
 	return true;
 }
 
-bool ask_transmitter_t::send(const void* message_data, size_t message_byte_length)
+#if DEVICE_PORTOUT
+bool ask_transmitter_t::_send_lanes(uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const void* message_data, size_t message_byte_length)
 {
-	return send(ASK_TRANSMITTER_BROADCAST_ADDRESS, message_data, message_byte_length);
+	static const uint8_t preamble_and_start_symbol[8] = { 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x38, 0x2C };
+
+	// the packet is the same as in single pin mode, but it is striped across the lanes
+	// so the whole packet is build before writing anything to the buffer
+	uint8_t packet[7 + ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE];
+	size_t packet_length = 7 + message_byte_length;
+	packet[0] = (uint8_t)packet_length;
+	packet[1] = rx_address;
+	packet[2] = tx_address;
+	packet[3] = header_id;
+	packet[4] = header_flags;
+	for (size_t i = 0; i != message_byte_length; ++i)
+		packet[5 + i] = *(const uint8_t*)((uintptr_t)message_data + i);
+
+	// crc init is 0xFFFF and xorout is 0xFFFF
+	uint16_t crc = 0xFFFF;
+	for (size_t i = 0; i != packet_length - 2; ++i)
+		crc = _kermit.fastCRC(crc, packet[i]);
+	crc ^= 0xFFFF;
+	packet[packet_length - 2] = (uint8_t)(crc & 0xFF);
+	packet[packet_length - 1] = (uint8_t)(crc >> 8);
+
+	uint8_t symbols[ASK_TRANSMITTER_MAXIMUM_LANES];
+	uint8_t lanes = _tx_lanes;
+
+	// every lane sends the preamble and the start symbol
+	for (size_t i = 0; i != sizeof(preamble_and_start_symbol); ++i)
+	{
+		for (uint8_t lane = 0; lane != lanes; ++lane)
+			symbols[lane] = preamble_and_start_symbol[i];
+		_write_lane_symbols(symbols);
+	}
+
+	// byte n of the packet is send by lane n % lanes, the last bytes are padded with zero bytes
+	for (size_t i = 0; i < packet_length; i += lanes)
+	{
+		for (uint8_t lane = 0; lane != lanes; ++lane)
+			symbols[lane] = _encode_symbol(_high_nibble(i + lane < packet_length ? packet[i + lane] : 0));
+		_write_lane_symbols(symbols);
+		for (uint8_t lane = 0; lane != lanes; ++lane)
+			symbols[lane] = _encode_symbol(_low_nibble(i + lane < packet_length ? packet[i + lane] : 0));
+		_write_lane_symbols(symbols);
+	}
+
+	// write 0 after the packet to set all lanes low after the packet is send
+	for (uint8_t lane = 0; lane != lanes; ++lane)
+		symbols[lane] = 0;
+	_write_lane_symbols(symbols);
+
+	++_packets_send;
+	_bytes_send += message_byte_length;
+
+	return true;
 }
+#endif
 
 void ask_transmitter_t::status(ask_transmitter_status_t* current_status)
 {
@@ -198,6 +407,7 @@ void ask_transmitter_t::status(ask_transmitter_status_t* current_status)
 	{
 		current_status->tx_frequency = _tx_frequency;
 		current_status->tx_pin = _tx_pin_name;
+		current_status->tx_lanes = _tx_lanes ? (int)_tx_lanes : 1;
 		current_status->tx_address = tx_address;
 		current_status->initialized = true;
 		if (_tx_buffer_read_index != _tx_buffer_write_index || _tx_output_symbol_bit_index)
@@ -206,16 +416,21 @@ void ask_transmitter_t::status(ask_transmitter_status_t* current_status)
 			current_status->active = false;
 		current_status->packets_send = _packets_send;
 		current_status->bytes_send = _bytes_send;
+		current_status->interrupts = _interrupts;
+		current_status->interrupt_cycles = _interrupt_cycles;
 	}
 	else
 	{
 		current_status->tx_frequency = 0;
 		current_status->tx_pin = NC;
+		current_status->tx_lanes = 0;
 		current_status->tx_address = ASK_TRANSMITTER_BROADCAST_ADDRESS;
 		current_status->initialized = false;
 		current_status->active = false;
 		current_status->packets_send = 0;
 		current_status->bytes_send = 0;
+		current_status->interrupts = 0;
+		current_status->interrupt_cycles = 0;
 	}
 }
 
@@ -232,6 +447,14 @@ bool ask_transmitter_t::is_valid_frequency(int frequency)
 	return valid_frequency;
 }
 
+void ask_transmitter_t::_tx_timed_interrupt_handler()
+{
+	uint32_t start = ask_transmitter_cycle_counter();
+	(this->*_tx_handler)();
+	_interrupt_cycles += ask_transmitter_cycle_counter() - start;
+	_interrupts++;
+}
+
 void ask_transmitter_t::_tx_interrupt_handler()
 {
 	// read next byte if !symbol_bit_index and if no data to send return from this function
@@ -276,6 +499,24 @@ void ask_transmitter_t::_tx_interrupt_handler()
 	_ask_transmitter->_tx_output_symbol_bit_index = symbol_bit_index;
 }
 
+#if DEVICE_PORTOUT
+void ask_transmitter_t::_tx_port_interrupt_handler()
+{
+	// read next symbols of all lanes if !symbol_bit_index and if no data to send return from this function
+	uint8_t symbol_bit_index = _ask_transmitter->_tx_output_symbol_bit_index;
+	if (!symbol_bit_index && !_ask_transmitter->_read_lane_symbols())
+		return;
+
+	// write bit number symbol_bit_index of every lane with one port write
+	port_write(&_ask_transmitter->_tx_port, (int)_ask_transmitter->_tx_port_output[symbol_bit_index++]);
+
+	// after sending 6 low bits of current symbols start sending next symbols
+	if (symbol_bit_index == 6)
+		symbol_bit_index = 0;
+	_ask_transmitter->_tx_output_symbol_bit_index = symbol_bit_index;
+}
+#endif
+
 uint8_t ask_transmitter_t::_high_nibble(uint8_t byte)
 {
 	return byte >> 4;
@@ -329,4 +570,53 @@ bool ask_transmitter_t::_read_byte_from_buffer(uint8_t* data)
 		return true;
 	}
 	return false;
-}
\ No newline at end of file
+}
+
+#if DEVICE_PORTOUT
+void ask_transmitter_t::_write_lane_symbols(const uint8_t* symbols)
+{
+	// wait for space for symbols of all lanes in the buffer, the symbols are written before the write index is moved
+	// so the interrupt handler never sees symbols of only some of the lanes
+	uint8_t lanes = _tx_lanes;
+	for (;;)
+	{
+		size_t read_index = _tx_buffer_read_index;
+		size_t write_index = _tx_buffer_write_index;
+		size_t free_space = read_index > write_index ? read_index - write_index - 1 : ASK_TRANSMITTER_BUFFER_SIZE - 1 - (write_index - read_index);
+		if (free_space >= (size_t)lanes)
+		{
+			for (uint8_t lane = 0; lane != lanes; ++lane)
+			{
+				_tx_buffer[write_index++] = symbols[lane];
+				if (write_index == ASK_TRANSMITTER_BUFFER_SIZE)
+					write_index = 0;
+			}
+			_tx_buffer_write_index = write_index;
+			return;
+		}
+	}
+}
+
+bool ask_transmitter_t::_read_lane_symbols()
+{
+	// read next symbols of all lanes and compute the port value for each of the 6 bits
+	size_t read_index = _tx_buffer_read_index;
+	if (read_index == _tx_buffer_write_index)
+		return false;
+
+	uint32_t port_output[6] = { 0, 0, 0, 0, 0, 0 };
+	for (uint8_t lane = 0, lanes = _tx_lanes; lane != lanes; ++lane)
+	{
+		uint8_t symbol = _tx_buffer[read_index++];
+		if (read_index == ASK_TRANSMITTER_BUFFER_SIZE)
+			read_index = 0;
+		for (uint8_t bit = 0; bit != 6; ++bit)
+			port_output[bit] |= (uint32_t)((symbol >> bit) & 1) << _tx_lane_shift[lane];
+	}
+	for (uint8_t bit = 0; bit != 6; ++bit)
+		_tx_port_output[bit] = port_output[bit];
+
+	_tx_buffer_read_index = read_index;
+	return true;
+}
+#endif
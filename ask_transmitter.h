@@ -6,6 +6,13 @@
 		Simple ask transmitter for Mbed OS.
 		The transmitter can be used to communicate with RadioHead library.
 
+	Local modifications
+		Changes made in this project on top of the upstream version above, not part of mbed-os-ask.
+		2026-10-19
+			interrupts and interrupt_cycles members added to ask_transmitter_status_t.
+			Multi-lane mode added, init overload for GPIO port and tx_lanes member added to ask_transmitter_status_t.
+			send_large member function added.
+
 	Version history
 		version 1.3.2 2018-08-01
 			Wired debug mode added.
@@ -65,15 +72,33 @@
 #define ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE 0xF8
 #define ASK_TRANSMITTER_BROADCAST_ADDRESS 0xFF
 
+// header flag of packets that are fragments of a message send by send_large
+#define ASK_TRANSMITTER_FLAG_FRAGMENT 0x01
+
+// every fragment begins with 16-bit sequence number and 32-bit total length of the message, both little endian
+#define ASK_TRANSMITTER_FRAGMENT_HEADER_SIZE 6
+// the default fragment size makes a packet of 63 bytes that fits in the default 64 byte receiver buffer
+#ifndef ASK_TRANSMITTER_FRAGMENT_DATA_SIZE
+#define ASK_TRANSMITTER_FRAGMENT_DATA_SIZE 50
+#endif
+#define ASK_TRANSMITTER_MAXIMUM_LARGE_MESSAGE_SIZE ((size_t)0x10000 * ASK_TRANSMITTER_FRAGMENT_DATA_SIZE)
+
+// maximum number of lanes in multi-lane mode, the buffer needs to fit at least one symbol of every lane
+#define ASK_TRANSMITTER_MAXIMUM_LANES 8
+
 typedef struct ask_transmitter_status_t
 {
 	int tx_frequency;
 	PinName tx_pin;
+	int tx_lanes;
 	uint8_t tx_address;
 	bool initialized;
 	bool active;
 	size_t packets_send;
 	size_t bytes_send;
+	// number of interrupts and cpu clock cycles (SystemCoreClock) spent in the interrupt handler since init, both wrap around
+	uint32_t interrupts;
+	uint32_t interrupt_cycles;
 } ask_transmitter_status_t;
 
 class ask_transmitter_t : public Ticker
@@ -129,6 +154,35 @@ class ask_transmitter_t : public Ticker
 				If the function succeeds, the return value is true and false on failure.
 		*/
 		
+#if DEVICE_PORTOUT
+		bool init(int tx_frequency, PortName tx_port, uint32_t tx_lane_mask, uint8_t new_tx_address);
+		/*
+			Description
+				Initializes the transmitter object in multi-lane mode. If the transmitter is already initialized it is reinitialized with the new parameters.
+				In multi-lane mode every pin of tx_lane_mask is a lane of its own and all lanes are written together with one port write every tick.
+				Every lane sends the preamble and the start symbol, after them the bytes of the packet are striped across the lanes,
+				byte n of the packet is send by lane n % lanes and the last bytes are padded with zero bytes so that every lane sends equal number of bytes.
+				Lanes are numbered from the least significant bit of tx_lane_mask, the receiver needs to use the same order.
+				The wired debug mode does not affect multi-lane mode.
+				This function fails if an initialized transmitter already exists.
+				Value of tx_address is set to the new tx address.
+			Parameters
+				tx_frequency
+					The frequency of the transmitter. This value is required to be valid frequency or 0, or the function fails.
+					Valid frequencies are 1000, 1250, 2500 and 3125.
+					If this parameter is 0 the transmitter is shutdown like by the other init functions.
+				tx_port
+					Mbed OS port name for the port of the lanes.
+				tx_lane_mask
+					Mask of the pins of the port that are used as lanes.
+					The mask needs to have at least one and at most ASK_TRANSMITTER_MAXIMUM_LANES bits set.
+				new_tx_address
+					tx address for the transmitter.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+#endif
+
 		bool send(uint8_t rx_address, const void* message_data, size_t message_byte_length);
 		/*
 			Description
@@ -164,6 +218,28 @@ class ask_transmitter_t : public Ticker
 				If the function succeeds, the return value is true and false on failure.
 		*/
 
+		bool send_large(uint8_t rx_address, const void* message_data, size_t message_byte_length);
+		/*
+			Description
+				Splits message that may be longer than ASK_TRANSMITTER_MAXIMUM_MESSAGE_SIZE to fragments and writes a packet for every fragment to the buffer of the transmitter.
+				The message is reassembled by recv_large function of the receiver.
+				Every fragment carries ASK_TRANSMITTER_FRAGMENT_DATA_SIZE bytes of the message except the last one, which carries the rest.
+				Fragments are numbered with 16-bit sequence numbers starting from 0 and carry the total length of the message.
+				The packets have ASK_TRANSMITTER_FLAG_FRAGMENT header flag set.
+				This function will block, until all the packets are written to the buffer.
+				The transmitter is required to be initialized or this function will fail.
+			Parameters
+				rx_address
+					Address of the receiver.
+				message_data
+					Pointer to the data to by send.
+				message_byte_length
+					The number of bytes to be send.
+					maximum value for this parameter is ASK_TRANSMITTER_MAXIMUM_LARGE_MESSAGE_SIZE.
+			Return
+				If the function succeeds, the return value is true and false on failure.
+		*/
+
 		void status(ask_transmitter_status_t* current_status);
 		/*
 			Description
@@ -194,6 +270,15 @@ class ask_transmitter_t : public Ticker
 	private :
 	    // KJ puukko ei static seuraavat 4
 		void _tx_interrupt_handler();
+		void _tx_timed_interrupt_handler();
+		bool _send(uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const void* message_data, size_t message_byte_length);
+		void _shutdown();
+#if DEVICE_PORTOUT
+		void _tx_port_interrupt_handler();
+		bool _send_lanes(uint8_t rx_address, uint8_t header_id, uint8_t header_flags, const void* message_data, size_t message_byte_length);
+		void _write_lane_symbols(const uint8_t* symbols);
+		bool _read_lane_symbols();
+#endif
 	    uint8_t _high_nibble(uint8_t byte);
 		uint8_t _low_nibble(uint8_t byte);
 		uint8_t _encode_symbol(uint8_t _4bit_data);
@@ -206,17 +291,34 @@ class ask_transmitter_t : public Ticker
 		gpio_t _tx_pin;
 		size_t _packets_send;
 		size_t _bytes_send;
+		// the ticker calls _tx_timed_interrupt_handler that measures the time spent in _tx_handler
+		void (ask_transmitter_t::*_tx_handler)();
+		volatile uint32_t _interrupts;
+		volatile uint32_t _interrupt_cycles;
 		uint8_t _tx_output_symbol;
 		volatile uint8_t _tx_output_symbol_bit_index;
 		volatile size_t _tx_buffer_read_index;
 		volatile size_t _tx_buffer_write_index;
 		volatile uint8_t _tx_buffer[ASK_TRANSMITTER_BUFFER_SIZE];
+
+		// multi-lane mode, _tx_lanes is 0 when the transmitter uses single tx pin
+		uint8_t _tx_lanes;
+#if DEVICE_PORTOUT
+		port_t _tx_port;
+		uint8_t _tx_lane_shift[ASK_TRANSMITTER_MAXIMUM_LANES];
+		// port values of the 6 bits of the current symbols of all lanes
+		uint32_t _tx_port_output[6];
+#endif
 		// KJ puukko peritään Ticker
 		//Ticker _tx_timer;
 
 		// transmitter initialization parameters
 		int _tx_frequency;
 		PinName _tx_pin_name;
+#if DEVICE_PORTOUT
+		PortName _tx_port_name;
+		uint32_t _tx_lane_mask;
+#endif
 
 		// No copying object of this type!
 		// KJ puukko ei estetä kopiointia
@@ -0,0 +1,181 @@
+/*
+	CRC16 benchmark for host builds.
+
+	Description
+		Measures every CALC_METHOD of CRC16 over the frame sizes used on the link:
+		7 byte headers, 59 byte frames and the whole 1402 byte table from pakattu_kuva.h,
+		plus a 1 MiB capture made of repeated copies of the table for the bulk methods.
+		All methods are run with the KERMIT model that the ask transmitter and receiver use
+		and their results are cross-checked against each other, a mismatch makes the program fail.
+		Results are reported as nanoseconds per byte and, on x86 hosts, bytes per cycle.
+
+	Build
+		g++ -O2 -I.. crc_benchmark.cpp ../ask_CRC16.cpp -o crc_benchmark
+
+		This directory is ignored by mbed (.mbedignore), the benchmark is never part of the target build.
+*/
+
+#include "ask_CRC16.h"
+#include "../thread_lahetin/pakattu_kuva.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CRC_BENCHMARK_HAS_CYCLE_COUNTER
+#endif
+
+// minimum time spent measuring one method over one input
+#define CRC_BENCHMARK_MINIMUM_NANOSECONDS 50000000ull
+
+// KERMIT model parameters
+#define CRC_BENCHMARK_POLY 0x1021
+#define CRC_BENCHMARK_INIT 0x0000
+#define CRC_BENCHMARK_XOROUT 0x0000
+
+static CRC16 bitwise_crc(CRC_BENCHMARK_POLY, CRC_BENCHMARK_INIT, CRC_BENCHMARK_XOROUT, true, true, BITWISE);
+static CRC16 lookup_crc(CRC_BENCHMARK_POLY, CRC_BENCHMARK_INIT, CRC_BENCHMARK_XOROUT, true, true, LOOKUP_TABLE);
+static CRC16 fast_crc(CRC_BENCHMARK_POLY, CRC_BENCHMARK_INIT, CRC_BENCHMARK_XOROUT, true, true, FAST_CRC);
+static CRC16 sandels_crc(CRC_BENCHMARK_POLY, CRC_BENCHMARK_INIT, CRC_BENCHMARK_XOROUT, true, true, SANDELS);
+
+static uint16_t bitwise_method(const uint8_t* data, size_t length)
+{
+	uint16_t crc = bitwise_crc.init;
+	for (size_t i = 0; i != length; ++i)
+		crc = bitwise_crc.incompleteBitwiseCompute(crc, data[i]);
+	return bitwise_crc.complete(crc);
+}
+
+static uint16_t lookup_table_method(const uint8_t* data, size_t length)
+{
+	uint16_t crc = lookup_crc.init;
+	for (size_t i = 0; i != length; ++i)
+		crc = lookup_crc.incompleteLookupCompute(crc, data[i]);
+	return lookup_crc.complete(crc);
+}
+
+// FAST_CRC and SANDELS work on the reflected crc, KERMIT init 0 is the same value reflected
+static uint16_t fast_crc_method(const uint8_t* data, size_t length)
+{
+	uint16_t crc = CRC_BENCHMARK_INIT;
+	for (size_t i = 0; i != length; ++i)
+		crc = fast_crc.fastCRC(crc, data[i]);
+	return crc ^ CRC_BENCHMARK_XOROUT;
+}
+
+static uint16_t fast_crc_bulk_method(const uint8_t* data, size_t length)
+{
+	return fast_crc.fastCRC(CRC_BENCHMARK_INIT, data, length) ^ CRC_BENCHMARK_XOROUT;
+}
+
+static uint16_t sandels_method(const uint8_t* data, size_t length)
+{
+	uint16_t crc = CRC_BENCHMARK_INIT;
+	for (size_t i = 0; i != length; ++i)
+		crc = sandels_crc.sandels(crc, data[i]);
+	return crc ^ CRC_BENCHMARK_XOROUT;
+}
+
+typedef struct crc_benchmark_method_t
+{
+	const char* name;
+	uint16_t (*compute)(const uint8_t* data, size_t length);
+} crc_benchmark_method_t;
+
+// the first method is the reference all the others are checked against
+static const crc_benchmark_method_t methods[] = {
+	{ "BITWISE", bitwise_method },
+	{ "LOOKUP_TABLE", lookup_table_method },
+	{ "FAST_CRC", fast_crc_method },
+	{ "SANDELS", sandels_method },
+	{ "FAST_CRC bulk", fast_crc_bulk_method },
+};
+
+typedef struct crc_benchmark_input_t
+{
+	const char* name;
+	size_t length;
+} crc_benchmark_input_t;
+
+static const crc_benchmark_input_t inputs[] = {
+	{ "header", 7 },
+	{ "frame", 59 },
+	{ "table", sizeof(table) },
+	{ "capture", 1 << 20 },
+};
+
+static uint8_t capture[1 << 20];
+
+static volatile uint16_t crc_sink;
+
+static void measure(const crc_benchmark_method_t* method, const uint8_t* data, size_t length)
+{
+	unsigned long long rounds = 0;
+	unsigned long long nanoseconds = 0;
+#ifdef CRC_BENCHMARK_HAS_CYCLE_COUNTER
+	unsigned long long cycles = 0;
+#endif
+
+	// run the method in batches until enough time has been spent to get a stable result
+	for (unsigned long long batch = 16; nanoseconds < CRC_BENCHMARK_MINIMUM_NANOSECONDS; batch *= 2)
+	{
+		std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+#ifdef CRC_BENCHMARK_HAS_CYCLE_COUNTER
+		unsigned long long start_cycle = __rdtsc();
+#endif
+		for (unsigned long long i = 0; i != batch; ++i)
+			crc_sink = method->compute(data, length);
+#ifdef CRC_BENCHMARK_HAS_CYCLE_COUNTER
+		cycles += __rdtsc() - start_cycle;
+#endif
+		nanoseconds += (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+		rounds += batch;
+	}
+
+	double bytes = (double)rounds * (double)length;
+#ifdef CRC_BENCHMARK_HAS_CYCLE_COUNTER
+	printf("  %-14s %10.3f ns/B %10.4f B/cycle\n", method->name, (double)nanoseconds / bytes, bytes / (double)cycles);
+#else
+	printf("  %-14s %10.3f ns/B %10s B/cycle\n", method->name, (double)nanoseconds / bytes, "-");
+#endif
+}
+
+int main()
+{
+	const size_t method_count = sizeof(methods) / sizeof(*methods);
+	const uint8_t* data = capture;
+	bool outputs_match = true;
+
+	// every input starts with the table, the capture continues with more copies of it
+	for (size_t i = 0; i != sizeof(capture); ++i)
+		capture[i] = (uint8_t)table[i % sizeof(table)];
+
+	for (size_t i = 0; i != sizeof(inputs) / sizeof(*inputs); ++i)
+	{
+		printf("%s (%u bytes)\n", inputs[i].name, (unsigned int)inputs[i].length);
+
+		// cross-check the results before measuring
+		uint16_t reference = methods[0].compute(data, inputs[i].length);
+		for (size_t j = 1; j != method_count; ++j)
+		{
+			uint16_t crc = methods[j].compute(data, inputs[i].length);
+			if (crc != reference)
+			{
+				printf("  %s result 0x%04X does not match %s result 0x%04X\n", methods[j].name, crc, methods[0].name, reference);
+				outputs_match = false;
+			}
+		}
+
+		for (size_t j = 0; j != method_count; ++j)
+			measure(&methods[j], data, inputs[i].length);
+	}
+
+	if (!outputs_match)
+	{
+		printf("FAILED: CRC methods do not agree\n");
+		return 1;
+	}
+	return 0;
+}
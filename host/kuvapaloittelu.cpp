@@ -0,0 +1,114 @@
+/*
+	Image chunking dry run for the image transfer application.
+
+	Description
+		Reads an image file through the same KuvaLahde interface the sender uses (TiedostoLahde,
+		thread_lahetin/kuvalahde.h) and cuts it into chunks the way the sender does for each given
+		chunk size: chunks of a JPEG end at segment and restart interval boundaries
+		(JpegPaloittelija, thread_lahetin/jpeg.h), other files are cut to full chunks.
+		For every chunk size the number of frames, the average chunk and the number of chunks cut
+		short at a boundary are printed, so throughput tests can be planned with real sized images
+		instead of the 1402 byte table compiled into the target.
+		The chunks are read back through the source and their CRC-32 is checked against the
+		streamed CRC-32 the sender puts into the info packet, and the LZ77 compressed size is
+		reported (the sender compresses only images that fit its 2 KiB buffer).
+
+	Usage
+		kuvapaloittelu image [chunk size ...]
+
+		chunk sizes default to 50, 100, 150 and 200 bytes.
+
+	Build
+		g++ -O2 -I.. -I../thread_lahetin kuvapaloittelu.cpp ../thread_lahetin/kuvalahde.cpp ../thread_lahetin/jpeg.cpp ../thread_lahetin/pakkaus.cpp ../ask_CRC32.cpp -o kuvapaloittelu
+
+		This directory is ignored by mbed (.mbedignore), the tool is never part of the target build.
+*/
+
+#include "kuvalahde.h"
+#include "jpeg.h"
+#include "pakkaus.h"
+#include "ask_CRC32.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// MIN_PACKET_DATA_SIZE of thread_lahetin/protokolla.h, which cannot be included on the host (mbed.h)
+#define KUVAPALOITTELU_MINIMUM_CHUNK 8
+#define KUVAPALOITTELU_MAXIMUM_CHUNK 255
+
+static bool dry_run(TiedostoLahde* source, uint32_t expected_crc, int chunk_size)
+{
+	JpegPaloittelija chunker;
+	bool jpeg = chunker.aloita(source);
+	uint32_t size = source->koko();
+	uint8_t chunk[KUVAPALOITTELU_MAXIMUM_CHUNK];
+	uint32_t crc = CRC32::begin();
+	unsigned int frames = 0;
+	unsigned int cut_short = 0;
+
+	for (uint32_t offset = 0; offset < size;) {
+		chunker.merkitse(offset);
+		int length = chunker.palanKoko(offset, chunk_size, KUVAPALOITTELU_MINIMUM_CHUNK);
+		if ((uint32_t)length > size - offset)
+			length = (int)(size - offset);
+		else if (length < chunk_size)
+			cut_short++;
+		if (length <= 0 || source->lue(offset, chunk, length) != length) {
+			fprintf(stderr, "kuvapaloittelu: read failed at %u\n", (unsigned int)offset);
+			return false;
+		}
+		crc = CRC32::update(crc, chunk, (size_t)length);
+		offset += (uint32_t)length;
+		frames++;
+	}
+
+	crc = CRC32::complete(crc);
+	printf("chunk %3i B: %5u frames, average %5.1f B", chunk_size, frames, frames ? (double)size / frames : 0.0);
+	if (jpeg)
+		printf(", %u cut at JPEG boundaries", cut_short);
+	printf("\n");
+	if (crc != expected_crc) {
+		fprintf(stderr, "kuvapaloittelu: CRC-32 of the chunks %08X does not match %08X\n", crc, expected_crc);
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "usage: kuvapaloittelu image [chunk size ...]\n");
+		return 1;
+	}
+	TiedostoLahde source;
+	if (!source.avaa(argv[1])) {
+		fprintf(stderr, "kuvapaloittelu: cannot open %s\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<int> chunk_sizes;
+	for (int i = 2; i < argc; ++i) {
+		int chunk_size = atoi(argv[i]);
+		if (chunk_size < KUVAPALOITTELU_MINIMUM_CHUNK || chunk_size > KUVAPALOITTELU_MAXIMUM_CHUNK) {
+			fprintf(stderr, "kuvapaloittelu: chunk size must be %i to %i bytes\n",
+				KUVAPALOITTELU_MINIMUM_CHUNK, KUVAPALOITTELU_MAXIMUM_CHUNK);
+			return 1;
+		}
+		chunk_sizes.push_back(chunk_size);
+	}
+	if (chunk_sizes.empty())
+		chunk_sizes = { 50, 100, 150, 200 };
+
+	uint32_t size = source.koko();
+	uint32_t crc = lahteenCrc32(&source);
+	std::vector<uint8_t> compressed(size + size / 2 + 16);
+	int compressed_size = pakkaa(PAKKAUS_LZ77, source.osoite(), (int)size, compressed.data(), (int)compressed.size());
+	printf("%s: %u B, CRC-32 %08X, %s, %s %i B\n", argv[1], (unsigned int)size, crc,
+		JpegPaloittelija().aloita(&source) ? "JPEG" : "not a JPEG", pakkauksenNimi(PAKKAUS_LZ77), compressed_size);
+
+	bool ok = true;
+	for (size_t i = 0; i != chunk_sizes.size(); ++i)
+		ok = dry_run(&source, crc, chunk_sizes[i]) && ok;
+	return ok ? 0 : 1;
+}
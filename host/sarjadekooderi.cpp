@@ -0,0 +1,135 @@
+/*
+	Serial output decoder for the image transfer application.
+
+	Description
+		Reads the serial output of thread_lahetin (JALJITYS_BINAARI and BINAARITULOSTE in main.cpp)
+		from a capture file, standard input or directly from the serial device and turns it back into text:
+		trace frames are expanded into status lines with the message dictionary in
+		thread_lahetin/jaljitysviestit.h, image frames are written to files and plain text between
+		the frames is printed as it is.
+		Frames are separated by zero bytes and text never contains one, so text ends up in blocks of
+		its own that fail the frame check (identifier, length and CRC-32).
+		The frame formats are described in thread_lahetin/sarjakehys.h.
+		The dictionary is compiled in, so the decoder has to be built from the same tree as the target.
+
+	Usage
+		sarjadekooderi [input] [output prefix]
+
+		input defaults to standard input, output prefix defaults to "kuva" and the images are
+		written as <prefix>_<n>.jpg. For a serial device, set it to raw mode first, e.g.
+		stty -F /dev/ttyACM0 9600 raw && ./sarjadekooderi /dev/ttyACM0
+
+	Build
+		g++ -O2 -I.. -I../thread_lahetin sarjadekooderi.cpp ../thread_lahetin/sarjakehys.cpp ../thread_lahetin/jaljitys.cpp ../thread_lahetin/pakkaus.cpp ../ask_CRC32.cpp -o sarjadekooderi
+
+		This directory is ignored by mbed (.mbedignore), the decoder is never part of the target build.
+*/
+
+#include "sarjakehys.h"
+#include "jaljitys.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+// largest accepted frame, the receiver prints at most its 3000 byte data table
+#define SARJADEKOODERI_MAXIMUM_FRAME (1 << 20)
+
+static const char* output_prefix = "kuva";
+static unsigned int images_written = 0;
+static unsigned int traces_expanded = 0;
+static unsigned int frames_rejected = 0;
+
+static void write_image(const uint8_t* image, uint32_t length, uint8_t state)
+{
+	char file_name[256];
+	snprintf(file_name, sizeof(file_name), "%s_%u.jpg", output_prefix, images_written);
+	FILE* file = fopen(file_name, "wb");
+	if (!file || fwrite(image, 1, length, file) != length) {
+		fprintf(stderr, "sarjadekooderi: cannot write %s\n", file_name);
+		if (file)
+			fclose(file);
+		return;
+	}
+	fclose(file);
+	images_written++;
+	printf("sarjadekooderi: %s, %u bytes%s\n", file_name, (unsigned int)length,
+		state == SARJAKEHYS_KUNNOSSA ? "" : " (receiver reported the image as incomplete or corrupted)");
+}
+
+static void process_block(const std::vector<uint8_t>& block, std::vector<uint8_t>* frame)
+{
+	if (block.empty())
+		return;
+
+	frame->resize(block.size());
+	int length = cobsPura(block.data(), (int)block.size(), frame->data(), (int)frame->size());
+	if (length > 0) {
+		uint32_t words[1 + JALJITYS_MAX_ARGUMENTTEJA];
+		int word_count = lueJaljitysKehys(frame->data(), length, words, 1 + JALJITYS_MAX_ARGUMENTTEJA);
+		if (word_count > 0) {
+			char line[256];
+			muotoileJaljitys(line, sizeof(line), words, word_count);
+			printf("%s\n", line);
+			traces_expanded++;
+			return;
+		}
+		const uint8_t* image;
+		uint32_t image_length;
+		uint8_t state;
+		if (lueKuvaKehys(frame->data(), length, &image, &image_length, &state)) {
+			write_image(image, image_length, state);
+			return;
+		}
+	}
+
+	// blocks that start like a frame are damaged frames, the rest is text
+	if (block.size() > 1 && (block[1] == SARJAKEHYS_JALJITYS || block[1] == SARJAKEHYS_TUNNISTE)) {
+		frames_rejected++;
+		printf("sarjadekooderi: damaged frame, %u bytes\n", (unsigned int)block.size());
+		return;
+	}
+	fwrite(block.data(), 1, block.size(), stdout);
+}
+
+int main(int argc, char** argv)
+{
+	int input = STDIN_FILENO;
+	if (argc > 1 && strcmp(argv[1], "-")) {
+		input = open(argv[1], O_RDONLY);
+		if (input < 0) {
+			fprintf(stderr, "sarjadekooderi: cannot open %s\n", argv[1]);
+			return 1;
+		}
+	}
+	if (argc > 2)
+		output_prefix = argv[2];
+
+	// read returns whatever has arrived, so a live serial device is decoded line by line
+	std::vector<uint8_t> block;
+	std::vector<uint8_t> frame;
+	uint8_t buffer[4096];
+	for (;;) {
+		ssize_t read_size = read(input, buffer, sizeof(buffer));
+		if (read_size <= 0)
+			break;
+		for (ssize_t i = 0; i != read_size; ++i) {
+			if (!buffer[i]) {
+				process_block(block, &frame);
+				block.clear();
+			}
+			else if (block.size() < SARJADEKOODERI_MAXIMUM_FRAME)
+				block.push_back(buffer[i]);
+		}
+		fflush(stdout);
+	}
+	process_block(block, &frame);
+
+	if (input != STDIN_FILENO)
+		close(input);
+	fprintf(stderr, "sarjadekooderi: %u trace lines, %u images written, %u damaged frames\n",
+		traces_expanded, images_written, frames_rejected);
+	return frames_rejected ? 1 : 0;
+}
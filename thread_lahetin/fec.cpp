@@ -0,0 +1,240 @@
+#include "fec.h"
+
+// Säätimen aloitusarvot ennen ensimmäistä kuittausta
+#define FEC_ALKU_K 4
+#define FEC_ALKU_P 0
+
+// Katoamisosuuden rajat pariteeteille (256 = kaikki katoavat)
+#define FEC_PARITEETTI_RAJA 3		// yli 1 %: ensimmäinen pariteetti
+#define FEC_PARITEETTI_ASKEL 16		// joka 6 % lisää: seuraava pariteetti
+
+int kasaaPariteetti(int8_t* kohde, const int8_t (*ryhma)[MAX_MESSAGE_SIZE], int k, int p, int j)
+{
+	// Pisin luokan paketti määrää pariteetin koon
+	int pituus = 0;
+	for (int i = j; i < k; i += p)
+		if ((uint8_t)ryhma[i][1] > pituus)
+			pituus = (uint8_t)ryhma[i][1];
+	pituus += FEC_PARITY_EXTRA;
+
+	for (int n = 0; n < pituus; n++)
+		kohde[HEADER_SIZE + n] = 0;
+	for (int i = j; i < k; i += p) {
+		int8_t* pariteetti = &kohde[HEADER_SIZE];
+		pariteetti[0] ^= ryhma[i][0];
+		pariteetti[1] ^= ryhma[i][1];
+		for (int n = 0; n < (uint8_t)ryhma[i][1]; n++)
+			pariteetti[FEC_PARITY_EXTRA + n] ^= ryhma[i][HEADER_SIZE + n];
+	}
+
+	kohde[0] = HEADER_PARITY_FLAG | (p & HEADER_PARITY_COUNT_MASK);
+	kohde[1] = pituus;
+	kohde[2] = ryhma[0][2];
+	kohde[3] = ryhma[0][3];
+	kohde[4] = ryhma[0][4];
+	kohde[5] = (int8_t)((j << 4) | (k - 1));
+	return HEADER_SIZE + pituus;
+}
+
+FecRyhma::FecRyhma()
+{
+	nollaa(0);
+}
+
+void FecRyhma::nollaa(uint8_t alku)
+{
+	tyhjenna(alku);
+}
+
+void FecRyhma::tyhjenna(uint8_t alku)
+{
+	_alku = alku;
+	_k = 0;
+	_p = 0;
+	_perus = 0;
+	_korjattuja = 0;
+	for (int i = 0; i < FEC_MAX_K; i++)
+		_saatu[i] = false;
+	for (int j = 0; j < FEC_MAX_P; j++)
+		_pariteetti_saatu[j] = false;
+}
+
+FecRyhma::Tulos FecRyhma::lisaa(const uint8_t* paketti, int koko)
+{
+	if (koko < HEADER_SIZE || koko > MAX_MESSAGE_SIZE)
+		return VIRHE;
+
+	bool pariteetti = paketti[0] & HEADER_PARITY_FLAG;
+	int indeksi = paketti[5] >> 4;
+	int k = (paketti[5] & 0x0F) + 1;
+	uint8_t alku = pariteetti ? paketti[4] : (uint8_t)(paketti[4] - indeksi);
+
+	if (k > FEC_MAX_K || (pariteetti ? indeksi >= FEC_MAX_P : indeksi >= k))
+		return VIRHE;
+
+	// Järjestysnumerot pyörähtävät ympäri, joten verrataan erotusta
+	int8_t ero = (int8_t)(alku - _alku);
+	if (ero < 0)
+		return VANHA;
+	if (ero > 0 || _k != k)
+		tyhjenna(alku);		// lähetin on siirtynyt seuraavaan ryhmään
+	_k = k;
+
+	if (pariteetti) {
+		// Uudelleenlähetyksessä pariteetteja voi olla eri määrä,
+		// jolloin aiemmin saadut pariteetit kattavat eri paketit
+		uint8_t p = paketti[0] & HEADER_PARITY_COUNT_MASK;
+		if (p == _p && _pariteetti_saatu[indeksi])
+			return TOISTO;
+		if (p != _p) {
+			for (int j = 0; j < FEC_MAX_P; j++)
+				_pariteetti_saatu[j] = false;
+			_p = p;
+		}
+		_perus = lueU16(&paketti[2]);
+		for (int n = 0; n < koko; n++)
+			_pariteetit[indeksi][n] = paketti[n];
+		_pariteetti_saatu[indeksi] = true;
+	}
+	else {
+		if (_saatu[indeksi])
+			return TOISTO;
+		for (int n = 0; n < koko; n++)
+			_paketit[indeksi][n] = paketti[n];
+		// Lähetin lisää kuittauspyynnön vasta lähettäessään, pariteetti on
+		// laskettu paketeista ilman sitä
+		_paketit[indeksi][0] &= (uint8_t)~HEADER_ACK_REQUEST_FLAG;
+		_saatu[indeksi] = true;
+	}
+
+	return korjaa() ? VALMIS : KESKEN;
+}
+
+bool FecRyhma::korjaa()
+{
+	// Tarkistetaan ensin, voidaanko kaikki puuttuvat korjata:
+	// jokaisesta luokasta saa puuttua vain yksi ja sen pariteetti pitää olla saatu
+	int puuttuu = 0;
+	for (int i = 0; i < _k; i++) {
+		if (_saatu[i])
+			continue;
+		puuttuu++;
+		if (_p == 0 || !_pariteetti_saatu[i % _p])
+			return false;
+		for (int m = i % _p; m < _k; m += _p)
+			if (m != i && !_saatu[m])
+				return false;
+	}
+	if (!puuttuu)
+		return true;
+
+	// Korjataan puuttuvat: pariteetti XOR luokan muut paketit
+	for (int i = 0; i < _k; i++) {
+		if (_saatu[i])
+			continue;
+		const uint8_t* pariteetti = &_pariteetit[i % _p][HEADER_SIZE];
+		int pituus = _pariteetit[i % _p][1];
+		uint8_t korjattu[MAX_MESSAGE_SIZE];
+		for (int n = 0; n < pituus; n++)
+			korjattu[n] = pariteetti[n];
+		for (int m = i % _p; m < _k; m += _p) {
+			if (m == i)
+				continue;
+			korjattu[0] ^= _paketit[m][0];
+			korjattu[1] ^= _paketit[m][1];
+			for (int n = 0; n < _paketit[m][1] && FEC_PARITY_EXTRA + n < pituus; n++)
+				korjattu[FEC_PARITY_EXTRA + n] ^= _paketit[m][HEADER_SIZE + n];
+		}
+		if (korjattu[1] > pituus - FEC_PARITY_EXTRA)
+			return false;
+
+		_paketit[i][0] = korjattu[0];
+		_paketit[i][1] = korjattu[1];
+		_paketit[i][4] = (uint8_t)(_alku + i);
+		_paketit[i][5] = (uint8_t)((i << 4) | (_k - 1));
+		for (int n = 0; n < korjattu[1]; n++)
+			_paketit[i][HEADER_SIZE + n] = korjattu[FEC_PARITY_EXTRA + n];
+		_saatu[i] = true;
+		_korjattuja++;
+	}
+
+	// Ryhmän palat ovat peräkkäisiä, joten alkukohdat saadaan kokojen summana
+	uint16_t alkukohta = _perus;
+	for (int i = 0; i < _k; i++) {
+		_paketit[i][2] = (uint8_t)(alkukohta & 0xFF);
+		_paketit[i][3] = (uint8_t)(alkukohta >> 8);
+		alkukohta += _paketit[i][1];
+	}
+	return true;
+}
+
+int FecRyhma::paketteja()
+{
+	return _k;
+}
+
+const uint8_t* FecRyhma::paketti(int i)
+{
+	return _paketit[i];
+}
+
+int FecRyhma::korjattuja()
+{
+	return _korjattuja;
+}
+
+void FecRyhma::seuraava()
+{
+	tyhjenna((uint8_t)(_alku + _k));
+}
+
+uint8_t FecRyhma::alku()
+{
+	return _alku;
+}
+
+uint16_t FecRyhma::saadut()
+{
+	uint16_t bitit = 0;
+	for (int i = 0; i < _k; i++)
+		if (_saatu[i])
+			bitit |= (uint16_t)(1 << i);
+	return bitit;
+}
+
+FecSaadin::FecSaadin(KatoamisArvio* katoaminen)
+{
+	_k = FEC_ALKU_K > FEC_MAX_K ? FEC_MAX_K : FEC_ALKU_K;
+	_p = FEC_ALKU_P > FEC_MAX_P ? FEC_MAX_P : FEC_ALKU_P;
+	_katoaminen = katoaminen;
+}
+
+int FecSaadin::k()
+{
+	return _k;
+}
+
+int FecSaadin::p()
+{
+	// Pariteetteja ei kannata olla enempää kuin ryhmässä on paketteja
+	return _p > _k ? _k : _p;
+}
+
+void FecSaadin::paivita()
+{
+	int osuus = _katoaminen->osuus();
+	if (osuus < FEC_PARITEETTI_RAJA) {
+		_p = 0;
+		_k = FEC_MAX_K;
+		return;
+	}
+	int p = 1 + (osuus - FEC_PARITEETTI_RAJA) / FEC_PARITEETTI_ASKEL;
+	_p = p > FEC_MAX_P ? FEC_MAX_P : p;
+
+	// Ryhmästä katoaa keskimäärin k * osuus / 256 pakettia, sen pitää
+	// olla enintään p / 2
+	int k = _p * 128 / osuus;
+	if (k > FEC_MAX_K)
+		k = FEC_MAX_K;
+	_k = k < 1 ? 1 : k;
+}
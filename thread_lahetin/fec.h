@@ -0,0 +1,124 @@
+/*
+* Virheenkorjaus (FEC) pariteettipaketeilla
+*
+* Lähetin lähettää K datapaketin ryhmän perään P pariteettipakettia.
+* Pariteettipaketti j on XOR niistä ryhmän paketeista, joiden indeksi i
+* täyttää ehdon i % P == j, joten vastaanotin voi korjata jokaisesta
+* pariteettiluokasta yhden kadonneen paketin odottamatta kuittauskellon
+* laukeamista ja uudelleenlähetystä. Peräkkäiset paketit ovat eri luokissa,
+* joten P peräkkäisen paketin katoaminen voidaan korjata.
+*
+* Pariteettipaketin dataosio on XOR ryhmän pakettien lipuista, datan
+* koosta ja nollilla täytetystä datasta. Datan alkukohdat lasketaan
+* ryhmän ensimmäisen paketin alkukohdasta, koska ryhmän palat ovat
+* peräkkäisiä.
+*/
+
+#ifndef FEC_H
+#define FEC_H
+
+#include <stdint.h>
+#include "protokolla.h"
+#include "katoamisarvio.h"
+
+// K = 1, P = 0 on tavallinen paketti kerrallaan kuittaus ilman FEC:iä
+#ifndef FEC_MAX_K
+#define FEC_MAX_K 8
+#endif
+#ifndef FEC_MAX_P
+#define FEC_MAX_P 2
+#endif
+
+#if FEC_MAX_K > 16 || FEC_MAX_P > 7 || FEC_MAX_K < 1
+#error FEC_MAX_K ja FEC_MAX_P eivät mahdu headeriin
+#endif
+
+// Pariteetin dataosiossa on datan lisäksi liput ja koko, joten datapalan
+// pitää olla sen verran pienempi, että pariteettipaketti mahtuu viestiin
+#define FEC_PARITY_EXTRA 2
+#define FEC_MAX_DATA_SIZE (MAX_PACKET_DATA_SIZE - FEC_PARITY_EXTRA)
+
+// Lähetin: kasaa ryhmän k paketista pariteettipaketin j kohteeseen,
+// palauttaa pariteettipaketin koko
+int kasaaPariteetti(int8_t* kohde, const int8_t (*ryhma)[MAX_MESSAGE_SIZE], int k, int p, int j);
+
+/*
+* Vastaanotin: kerää ryhmän paketit ja korjaa kadonneet pariteetin avulla
+*/
+class FecRyhma
+{
+public:
+	enum Tulos { KESKEN, VALMIS, VANHA, TOISTO, VIRHE };
+
+	FecRyhma();
+
+	// Uusi siirto alkaa järjestysnumerosta alku (tietopaketti)
+	void nollaa(uint8_t alku);
+
+	// Lisätään vastaanotettu data- tai pariteettipaketti.
+	// VALMIS: ryhmän kaikki datapaketit ovat saatavilla (paketti(i)),
+	// VANHA: paketti kuuluu jo käsiteltyyn ryhmään (kuittaus on kadonnut),
+	// TOISTO: sama paketti on jo saatu kesken olevaan ryhmään, sitä ei kopioida
+	Tulos lisaa(const uint8_t* paketti, int koko);
+
+	// Valmiin ryhmän datapakettien määrä ja paketit järjestyksessä
+	int paketteja();
+	const uint8_t* paketti(int i);
+
+	// Montako pakettia valmiissa ryhmässä korjattiin pariteetilla
+	int korjattuja();
+
+	// Valmis ryhmä on käsitelty, siirrytään seuraavaan
+	void seuraava();
+
+	// Kuittausta varten: kesken olevan ryhmän ensimmäinen järjestysnumero
+	// (kaikki sitä edeltävät on saatu) ja sen saadut paketit (bitti i = paketti i)
+	uint8_t alku();
+	uint16_t saadut();
+
+private:
+	void tyhjenna(uint8_t alku);
+	bool korjaa();
+
+	uint8_t _alku;			// ryhmän ensimmäisen paketin järjestysnumero
+	uint8_t _k;
+	uint8_t _p;
+	uint16_t _perus;		// ryhmän ensimmäisen paketin alkukohta
+	int _korjattuja;
+	bool _saatu[FEC_MAX_K];
+	uint8_t _paketit[FEC_MAX_K][MAX_MESSAGE_SIZE];
+	bool _pariteetti_saatu[FEC_MAX_P > 0 ? FEC_MAX_P : 1];
+	uint8_t _pariteetit[FEC_MAX_P > 0 ? FEC_MAX_P : 1][MAX_MESSAGE_SIZE];
+};
+
+/*
+* Lähetin: ryhmän koon K ja pariteettien määrän P säädin
+*
+* K ja P lasketaan pakettien mitatusta katoamisosuudesta (katoamisarvio.h). Häiriöttömällä
+* yhteydellä pariteetteja ei lähetetä ja ryhmä on suurin mahdollinen,
+* jolloin kuittauksia tarvitaan vähiten. Katoamisen kasvaessa pariteetteja
+* lisätään ja kun niitä on enimmäismäärä, ryhmää pienennetään niin, että
+* ryhmästä katoaa keskimäärin enintään puolet pariteettien määrästä.
+*
+* Pariteetilla korjattu paketti ei näy kuittauksessa kadonneena, joten
+* toimiva FEC laskee mitattua osuutta ja pariteetteja kevennetään, kunnes
+* katoamiset taas näkyvät.
+*/
+class FecSaadin
+{
+public:
+	FecSaadin(KatoamisArvio* katoaminen);
+
+	int k();
+	int p();
+
+	// Lasketaan K ja P uudelleen, kun katoamisarvio on päivitetty
+	void paivita();
+
+private:
+	uint8_t _k;
+	uint8_t _p;
+	KatoamisArvio* _katoaminen;
+};
+
+#endif
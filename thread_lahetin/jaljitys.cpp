@@ -0,0 +1,82 @@
+#include "jaljitys.h"
+#include "pakkaus.h"
+#include <stdio.h>
+#include <string.h>
+
+// Sanakirja, viittaamaton taulukko jää laitteen käännöksestä pois,
+// kun rivit muotoillaan isäntäkoneella
+static const char* const jaljitys_muodot[JALJITYS_VIESTEJA] =
+{
+#define JALJITYS(tunniste, muoto) muoto,
+#include "jaljitysviestit.h"
+#undef JALJITYS
+};
+
+int muotoileJaljitys(char* kohde, int koko, const uint32_t* sanat, int sanoja)
+{
+	if (koko <= 0)
+		return 0;
+	if (sanoja < 1 || sanat[0] >= JALJITYS_VIESTEJA)
+	{
+		int n = snprintf(kohde, koko, "jaljitys: tuntematon viesti %u", sanoja < 1 ? 0u : (unsigned int)sanat[0]);
+		return n < koko ? n : koko - 1;
+	}
+
+	const char* muoto = jaljitys_muodot[sanat[0]];
+	int kohta = 0;
+	int argumentti = 1;
+	while (*muoto && kohta < koko - 1)
+	{
+		if (*muoto != '%')
+		{
+			kohde[kohta++] = *muoto++;
+			continue;
+		}
+
+		// Muunnos kopioidaan snprintf:lle sellaisenaan liput ja leveys mukaan lukien
+		char maare[8];
+		int pituus = 0;
+		maare[pituus++] = *muoto++;
+		while (((*muoto >= '0' && *muoto <= '9') || *muoto == '-') && pituus < (int)sizeof(maare) - 2)
+			maare[pituus++] = *muoto++;
+		char muunnos = *muoto;
+		if (muunnos)
+			muoto++;
+
+		if (muunnos == '%')
+		{
+			kohde[kohta++] = '%';
+			continue;
+		}
+		// Puuttuva argumentti (sanakirja ja laite eri versiosta) näkyy kysymysmerkkinä
+		if (argumentti >= sanoja)
+		{
+			kohde[kohta++] = '?';
+			continue;
+		}
+		uint32_t arvo = sanat[argumentti++];
+
+		int n;
+		if (muunnos == 'P')
+			n = snprintf(&kohde[kohta], koko - kohta, "%s", pakkauksenNimi((Pakkaus)arvo));
+		else if (!muunnos || !strchr("uidxXc", muunnos))
+		{
+			kohde[kohta++] = '?';
+			continue;
+		}
+		else
+		{
+			maare[pituus++] = muunnos == 'd' ? 'i' : muunnos;
+			maare[pituus] = 0;
+			if (muunnos == 'i' || muunnos == 'd')
+				n = snprintf(&kohde[kohta], koko - kohta, maare, (int)(int32_t)arvo);
+			else
+				n = snprintf(&kohde[kohta], koko - kohta, maare, (unsigned int)arvo);
+		}
+		if (n < 0)
+			break;
+		kohta += n < koko - kohta ? n : koko - kohta - 1;
+	}
+	kohde[kohta] = 0;
+	return kohta;
+}
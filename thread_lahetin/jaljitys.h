@@ -0,0 +1,82 @@
+/*
+* Jäljitys: tilarivit muotoillaan vasta isäntäkoneella
+*
+* Threadit eivät muotoile tilarivejä printf:llä, vaan kirjoittavat
+* lokirenkaaseen (lokirengas.h) vain viestin numeron ja argumentit
+* 32-bittisinä sanoina. Kirjoitus on muutama sijoitus ja yksi
+* vertaa-ja-vaihda -operaatio, joten jäljitys voi olla päällä aikakriittisissäkin
+* silmukoissa.
+*
+* EventThread lähettää tietueet sarjaportille binäärisinä kehyksinä
+* (sarjakehys.h), ja isäntäkoneen purkaja (host/sarjadekooderi.cpp)
+* muotoilee ne teksteiksi sanakirjasta (jaljitysviestit.h). Ilman purkajaa
+* EventThread voi muotoilla rivit itse (JALJITYS_BINAARI, main.cpp).
+*/
+
+#ifndef JALJITYS_H
+#define JALJITYS_H
+
+#include <stdint.h>
+
+#define JALJITYS_MAX_ARGUMENTTEJA 6
+
+enum JaljitysId
+{
+#define JALJITYS(tunniste, muoto) tunniste,
+#include "jaljitysviestit.h"
+#undef JALJITYS
+	JALJITYS_VIESTEJA
+};
+
+// Tietue lokirenkaaseen: sanat[0] on viestin numero, sen perässä
+// argumentit (main.cpp)
+void jaljitaTietue(const uint32_t* sanat, int sanoja);
+
+inline void jaljita(JaljitysId id)
+{
+	uint32_t sanat[1] = { (uint32_t)id };
+	jaljitaTietue(sanat, 1);
+}
+
+inline void jaljita(JaljitysId id, uint32_t a)
+{
+	uint32_t sanat[2] = { (uint32_t)id, a };
+	jaljitaTietue(sanat, 2);
+}
+
+inline void jaljita(JaljitysId id, uint32_t a, uint32_t b)
+{
+	uint32_t sanat[3] = { (uint32_t)id, a, b };
+	jaljitaTietue(sanat, 3);
+}
+
+inline void jaljita(JaljitysId id, uint32_t a, uint32_t b, uint32_t c)
+{
+	uint32_t sanat[4] = { (uint32_t)id, a, b, c };
+	jaljitaTietue(sanat, 4);
+}
+
+inline void jaljita(JaljitysId id, uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+{
+	uint32_t sanat[5] = { (uint32_t)id, a, b, c, d };
+	jaljitaTietue(sanat, 5);
+}
+
+inline void jaljita(JaljitysId id, uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t e)
+{
+	uint32_t sanat[6] = { (uint32_t)id, a, b, c, d, e };
+	jaljitaTietue(sanat, 6);
+}
+
+inline void jaljita(JaljitysId id, uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t e, uint32_t f)
+{
+	uint32_t sanat[7] = { (uint32_t)id, a, b, c, d, e, f };
+	jaljitaTietue(sanat, 7);
+}
+
+// Muotoillaan tietue kohteeseen sanakirjan mukaan (ilman rivinvaihtoa),
+// palauttaa kirjoitettujen merkkien määrän. Rivi katkaistaan, jos se ei
+// mahdu, ja kohde päätetään aina nollalla.
+int muotoileJaljitys(char* kohde, int koko, const uint32_t* sanat, int sanoja);
+
+#endif
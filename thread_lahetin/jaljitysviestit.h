@@ -0,0 +1,90 @@
+/*
+* Jäljitysviestien sanakirja (jaljitys.h)
+*
+* JALJITYS(tunniste, muoto): tunnisteesta tulee viestin numero
+* (JaljitysId), muodosta sen teksti. Sama luettelo käännetään laitteelle
+* ja isäntäkoneen purkajaan, joten numerot ja tekstit pysyvät samoina.
+* Uudet viestit lisätään loppuun, jotta vanhat kaappaukset voi vielä
+* purkaa.
+*
+* Muunnokset: %u %i %d %x %X %c leveyksineen (esim. %04X), %% sekä
+* %P = pakkausmenetelmän nimi (pakkauksenNimi). Argumentit ovat 32-bittisiä
+* kokonaislukuja, enintään JALJITYS_MAX_ARGUMENTTEJA. Rivinvaihto
+* lisätään tulostettaessa.
+*
+* Tiedostolla ei ole include-suojausta, se luetaan jokaisen JALJITYS-
+* määrittelyn kanssa uudelleen.
+*/
+
+// lahetin.cpp
+JALJITYS(J1_PAKKAUS, "1: pakkaus %P: %u B -> %u B (%u %%)")
+JALJITYS(J1_JPEG_PALOITTELU, "1: JPEG, palat katkaistaan merkkien kohdalta")
+JALJITYS(J1_LUKUVIRHE_KOHDASSA, "1: VIRHE: kuvan lukeminen kohdasta %u epaonnistui")
+JALJITYS(J1_LUKUVIRHE, "1: VIRHE: kuvan lukeminen epaonnistui")
+JALJITYS(J1_RYHMA_LAHETETTY, "1: Lahetetty ryhmasta %i / %i + %i pariteettia, %i B")
+JALJITYS(J1_VASTAANOTIN_KUNNOSSA, "1: vastaanotin: kuva tarkistettu, %u B, kuittaus liitetty %u")
+JALJITYS(J1_VASTAANOTIN_VIRHEELLINEN, "1: vastaanotin: kuva VIRHEELLINEN, %u B, kuittaus liitetty %u")
+JALJITYS(J1_TUNTEMATON_KUITTAUS, "1: tuntematon kuittaus %i B")
+JALJITYS(J1_KUITTAUS, "1: kuittaus %u, saadut 0x%04X, ikkuna %u B")
+JALJITYS(J1_VASTAANOTTAJAN_IKKUNA, "1: vastaanottajan ikkuna %u B")
+JALJITYS(J1_EI_MAHDU_YLEISLAHETYKSEEN, "1: kuva ei mahdu yleislahetykseen (%i symbolia)")
+JALJITYS(J1_YLEISLAHETYS, "1: yleislahetys: %i symbolia, %i B")
+JALJITYS(J1_SYMBOLI_LAHETETTY, "1: Lahetetty symboli %u")
+JALJITYS(J1_EI_MAHDU_MONILAHETYKSEEN, "1: kuva ei mahdu monilahetykseen (%i palaa)")
+JALJITYS(J1_MONILAHETYS, "1: monilahetys: siirto %u, %i palaa")
+JALJITYS(J1_KIERROS_LAHETETTY, "1: kierros %i lahetetty, pyydettiin %i palaa")
+JALJITYS(J1_MONILAHETYS_VALMIS, "1: __________monilahetys valmis, kierroksia %i, lahetettyja paloja %u / %i, NACKeja %u ________")
+JALJITYS(J1_LAHETIN_ALUSTUS_EPAONNISTUI, "1: trasmitter1 initialization failed")
+JALJITYS(J1_LAHETIN_ALUSTETTU, "1: lahettimen lahetin1 alustettu")
+JALJITYS(J1_LAHETYS_EPAONNISTUI, "1: trasmitter sending failed")
+JALJITYS(J1_VASTAANOTIN_ALUSTUS_EPAONNISTUI, "1: receiver1 initialization failed")
+JALJITYS(J1_VASTAANOTIN_ALUSTETTU, "1: lahettimen vastaanotin1 alustettu")
+JALJITYS(J1_VIESTIN_KOKO, "1: viestin koko=%u B")
+JALJITYS(J1_TIETOPAKETTI_LAHETETTY, "1: Lahetetty tietopaketti %i B")
+JALJITYS(J1_KUITTAUSKELLO_LAUKESI, "1: kuittauskello laukesi")
+JALJITYS(J1_ODOTUSAIKA, "1: odotusaika %i ms")
+JALJITYS(J1_RYHMASTA_PUUTTUU, "1: ryhmasta puuttuu paketteja")
+JALJITYS(J1_KUITTAUS_VASTAANOTETTU, "1: kuittaus vastaanotettu")
+JALJITYS(J1_SIIRTO_VALMIS, "1: __________Offset reset, lahetettyja paketteja %i, palan koko %i B, ryhma %i + %i, odotusaika %i ms ________")
+JALJITYS(J1_JONO, "1: jono: suurin syvyys %i / %i, radio odotti %u kertaa, kasaaja odotti %u kertaa")
+
+// vastaanotin.cpp
+JALJITYS(J2_LAHETIN_ALUSTUS_EPAONNISTUI, "2: trasmitter2 initialization failed")
+JALJITYS(J2_LAHETIN_ALUSTETTU, "2: vastaanottimen lahetin2 alustettu")
+JALJITYS(J2_VASTAANOTIN_ALUSTUS_EPAONNISTUI, "2: receiver2 initialization failed")
+JALJITYS(J2_VASTAANOTIN_ALUSTETTU, "2: vastaanottimen vastaanotin2 alustettu")
+JALJITYS(J2_LAHETYS_EPAONNISTUI, "2: trasmitter sending failed")
+JALJITYS(J2_PURETTUA_LIIKAA, "2: VIRHE: purettua kuvaa tuli enemmän kuin ilmoitettiin")
+JALJITYS(J2_SIIRROSTA_PUUTTUU, "2: VIRHE: siirrosta puuttuu dataa")
+JALJITYS(J2_PAKATTU_VIRHEELLINEN, "2: VIRHE: pakattu data on virheellistä")
+JALJITYS(J2_SIIRRETTYA_LIIKAA, "2: VIRHE: siirrettyä dataa tuli enemmän kuin ilmoitettiin")
+JALJITYS(J2_ESIKATSELU_OTSIKOT, "2: esikatselu: JPEG-otsikot saatu (%u B)")
+JALJITYS(J2_ESIKATSELU_SCAN, "2: esikatselu: scan %i valmis (%u / %u B)")
+JALJITYS(J2_EI_MAHDU_TAULUKKOON, "2: kuva ei mahdu data-taulukkoon, tulostetaan %u B alusta")
+JALJITYS(J2_EI_TIETOPAKETTIA, "2: tietopakettia ei saatu, kuvaa ei voi tarkistaa")
+JALJITYS(J2_KUVA_VAJAA, "2: VIRHE: kuva vajaa, %u / %u B")
+JALJITYS(J2_CRC_VIRHE, "2: VIRHE: kuvan CRC-32 ei täsmää")
+JALJITYS(J2_SIIRTO_KUNNOSSA, "2: siirto vastaanotettu, kuva tarkistettu, data:")
+JALJITYS(J2_SIIRTO_VIRHEELLINEN, "2: siirto vastaanotettu, kuva VIRHEELLINEN, data:")
+JALJITYS(J2_SIIRTO_TILASTO, "2: siirretty %u B, kuva %u B (%P, %u %%), toistoja %u, liitettyja kuittauksia %u")
+JALJITYS(J2_VIRHEELLINEN_YLEISLAHETYS, "2: virheellinen yleislahetyksen paketti")
+JALJITYS(J2_YLEISLAHETYS_PURETTU, "2: yleislahetys purettu %i symbolista (K = %i)")
+JALJITYS(J2_VIRHEELLINEN_MONILAHETYS, "2: virheellinen monilahetyksen paketti")
+JALJITYS(J2_MONILAHETYS_SAATU, "2: monilahetys saatu, NACKeja %u, vaimennettuja %u")
+JALJITYS(J2_DATA_VASTAANOTETTU, "2: vastaanotettu data:")
+JALJITYS(J2_VIRHEELLINEN_RYHMA, "2: virheellinen ryhman paketti")
+JALJITYS(J2_KORJATTU_PARITEETILLA, "2: ryhmasta korjattu pariteetilla %i pakettia")
+
+// main.cpp (monitori.h)
+JALJITYS(J0_EKA_LAHETIN, "monitori: ekaLahetin: cpu %u.%u %%, pino %u / %u B")
+JALJITYS(J0_TOKA_LAHETIN, "monitori: tokaLahetin: cpu %u.%u %%, pino %u / %u B")
+JALJITYS(J0_RADIO_LAHETIN, "monitori: radioLahetin: cpu %u.%u %%, pino %u / %u B")
+JALJITYS(J0_EVENT_THREAD, "monitori: EventThread: cpu %u.%u %%, pino %u / %u B")
+JALJITYS(J0_MAIN, "monitori: main: cpu %u.%u %%")
+JALJITYS(J0_MUUT, "monitori: muut (idle): cpu %u.%u %%")
+JALJITYS(J0_ASK_LAHETTIMET, "monitori: ask-lahettimien keskeytykset: cpu %u.%u %%, %u kertaa")
+JALJITYS(J0_ASK_VASTAANOTTIMET, "monitori: ask-vastaanottimien keskeytykset: cpu %u.%u %%, %u kertaa")
+JALJITYS(J0_SARJAPUSKURI, "monitori: sarjapuskuri: suurin kaytto %u / %u B, taynna %u kertaa")
+
+// lahetin.cpp
+JALJITYS(J1_SIIRTO_KESKEYTETTY, "1: VIRHE: siirto keskeytetty kohdassa %u / %u B, aloitetaan alusta")
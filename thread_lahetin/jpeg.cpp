@@ -0,0 +1,284 @@
+#include "jpeg.h"
+
+static bool onRst(uint8_t merkki)
+{
+	return merkki >= JPEG_RST0 && merkki <= JPEG_RST7;
+}
+
+JpegPaloittelija::JpegPaloittelija()
+{
+	aloita(0);
+}
+
+bool JpegPaloittelija::aloita(KuvaLahde* lahde)
+{
+	_lahde = lahde;
+	_koko = lahde ? lahde->koko() : 0;
+	_nyt.vaihe = SEGMENTIT;
+	_nyt.kohta = 0;
+	_nyt.edellinen = 0;
+	_nyt.raja = 0;
+	_paluu_kelpaa = false;
+	_valimuistin_alku = 0;
+	_valimuistissa = 0;
+
+	uint8_t alku[2];
+	if (!lahde || !lue(0, &alku[0]) || !lue(1, &alku[1]) || alku[0] != JPEG_MERKKI || alku[1] != JPEG_SOI)
+		_lahde = 0;
+	return _lahde != 0;
+}
+
+bool JpegPaloittelija::kaytossa()
+{
+	return _lahde != 0;
+}
+
+bool JpegPaloittelija::lue(uint32_t kohta, uint8_t* tavu)
+{
+	if (kohta >= _koko)
+		return false;
+	if (_lahde->osoite()) {
+		*tavu = _lahde->osoite()[kohta];
+		return true;
+	}
+
+	// Lähde luetaan pieninä paloina, koska etsintä etenee byte kerrallaan
+	if (kohta < _valimuistin_alku || kohta >= _valimuistin_alku + _valimuistissa) {
+		int luettu = _lahde->lue(kohta, _valimuisti, sizeof(_valimuisti));
+		if (luettu <= 0)
+			return false;
+		_valimuistin_alku = kohta;
+		_valimuistissa = luettu;
+	}
+	*tavu = _valimuisti[kohta - _valimuistin_alku];
+	return true;
+}
+
+uint32_t JpegPaloittelija::askel()
+{
+	// Seuraava raja kohdasta _nyt.kohta, kuvan lopussa tai virheellisessä
+	// rakenteessa loppu on viimeinen raja
+	uint32_t p = _nyt.kohta;
+	uint8_t tavu;
+
+	if (_nyt.vaihe == SEGMENTIT) {
+		uint8_t merkki;
+		if (!lue(p, &tavu) || tavu != JPEG_MERKKI) {
+			_nyt.vaihe = LOPPU;
+			return _koko;
+		}
+		// Merkkiä voi edeltää täyte-FF:iä
+		while (lue(p + 1, &merkki) && merkki == JPEG_MERKKI)
+			p++;
+		if (!lue(p + 1, &merkki)) {
+			_nyt.vaihe = LOPPU;
+			return _koko;
+		}
+
+		uint32_t loppu = p + 2;
+		if (merkki == JPEG_EOI) {
+			_nyt.vaihe = LOPPU;
+		}
+		else if (merkki != JPEG_SOI && merkki != JPEG_TEM && !onRst(merkki)) {
+			uint8_t pituus[2];
+			if (!lue(p + 2, &pituus[0]) || !lue(p + 3, &pituus[1]) || ((pituus[0] << 8) | pituus[1]) < 2) {
+				_nyt.vaihe = LOPPU;
+				return _koko;
+			}
+			loppu += (pituus[0] << 8) | pituus[1];
+			if (merkki == JPEG_SOS)
+				_nyt.vaihe = ENTROPIA;
+		}
+		_nyt.kohta = loppu;
+		return loppu < _koko ? loppu : _koko;
+	}
+
+	if (_nyt.vaihe == ENTROPIA) {
+		// Entropiakoodatussa datassa FF 00 on data-byte FF, muut FF xx ovat merkkejä
+		while (lue(p, &tavu)) {
+			uint8_t seuraava;
+			if (tavu != JPEG_MERKKI) {
+				p++;
+				continue;
+			}
+			if (!lue(p + 1, &seuraava))
+				break;
+			if (seuraava == 0x00) {
+				p += 2;
+				continue;
+			}
+			if (seuraava == JPEG_MERKKI) {
+				p++;
+				continue;
+			}
+			// Restart-väli alkaa merkistään, muu merkki lopettaa scanin
+			if (onRst(seuraava)) {
+				_nyt.kohta = p + 2;
+			}
+			else {
+				_nyt.vaihe = SEGMENTIT;
+				_nyt.kohta = p;
+			}
+			return p;
+		}
+		_nyt.vaihe = LOPPU;
+	}
+	return _koko;
+}
+
+uint32_t JpegPaloittelija::seuraavaRaja(uint32_t kohta)
+{
+	// Etsintä etenee vain eteenpäin, taaksepäin palataan paluukohtaan
+	// tai kuvan alkuun
+	if (kohta < _nyt.edellinen) {
+		if (_paluu_kelpaa && _paluu.edellinen <= kohta) {
+			_nyt = _paluu;
+		}
+		else {
+			_nyt.vaihe = SEGMENTIT;
+			_nyt.kohta = 0;
+			_nyt.edellinen = 0;
+			_nyt.raja = 0;
+		}
+	}
+	while (_nyt.raja <= kohta && _nyt.raja < _koko) {
+		_nyt.edellinen = _nyt.raja;
+		_nyt.raja = askel();
+	}
+	return _nyt.raja;
+}
+
+int JpegPaloittelija::palanKoko(uint32_t alku, int koko, int pienin)
+{
+	if (!_lahde || koko <= 0)
+		return koko;
+
+	// Kuvan loppu on aina raja
+	uint32_t loppu = alku + koko;
+	if (loppu >= _koko)
+		return koko;
+	uint32_t viimeinen = alku;
+	for (uint32_t raja = seuraavaRaja(alku); raja < loppu && raja < _koko; raja = seuraavaRaja(raja))
+		viimeinen = raja;
+
+	if (viimeinen > alku && (int)(viimeinen - alku) >= pienin)
+		return (int)(viimeinen - alku);
+	return koko;
+}
+
+void JpegPaloittelija::merkitse(uint32_t alku)
+{
+	if (_lahde && _nyt.edellinen <= alku) {
+		_paluu = _nyt;
+		_paluu_kelpaa = true;
+	}
+}
+
+JpegSeuraaja::JpegSeuraaja()
+{
+	aloita();
+}
+
+void JpegSeuraaja::aloita()
+{
+	_vaihe = ALKU_FF;
+	_tyyppi = 0;
+	_jaljella = 0;
+	_scaneja = 0;
+	_valmiita = 0;
+	_kohta = 0;
+}
+
+bool JpegSeuraaja::merkki(uint8_t tyyppi)
+{
+	// Merkin tyyppi luettu, palauttaa true, kun otsikot ovat valmiit
+	// (ensimmäinen SOS)
+	_tyyppi = tyyppi;
+	if (tyyppi == JPEG_MERKKI) {
+		_vaihe = TYYPPI;		// täyte
+		return false;
+	}
+	if (tyyppi == JPEG_SOI || tyyppi == JPEG_TEM || onRst(tyyppi) || tyyppi == JPEG_EOI) {
+		_vaihe = MERKKI;
+		return false;
+	}
+	_vaihe = PITUUS1;
+	if (tyyppi == JPEG_SOS)
+		return ++_scaneja == 1;
+	return false;
+}
+
+bool JpegSeuraaja::lisaa(uint8_t tavu)
+{
+	_kohta++;
+	switch (_vaihe) {
+		case ALKU_FF:
+			_vaihe = tavu == JPEG_MERKKI ? ALKU_SOI : EI_JPEG;
+			return false;
+		case ALKU_SOI:
+			_vaihe = tavu == JPEG_SOI ? MERKKI : EI_JPEG;
+			return false;
+		case MERKKI:
+			_vaihe = tavu == JPEG_MERKKI ? TYYPPI : EI_JPEG;
+			return false;
+		case TYYPPI:
+			return merkki(tavu);
+		case PITUUS1:
+			_jaljella = (uint16_t)(tavu << 8);
+			_vaihe = PITUUS2;
+			return false;
+		case PITUUS2:
+			_jaljella |= tavu;
+			if (_jaljella < 2) {
+				_vaihe = EI_JPEG;
+				return false;
+			}
+			_jaljella -= 2;
+			if (_jaljella)
+				_vaihe = SEGMENTTI;
+			else
+				_vaihe = _tyyppi == JPEG_SOS ? ENTROPIA : MERKKI;
+			return false;
+		case SEGMENTTI:
+			if (--_jaljella == 0)
+				_vaihe = _tyyppi == JPEG_SOS ? ENTROPIA : MERKKI;
+			return false;
+		case ENTROPIA:
+			if (tavu == JPEG_MERKKI)
+				_vaihe = ENTROPIA_FF;
+			return false;
+		case ENTROPIA_FF:
+			if (tavu == 0x00 || onRst(tavu)) {
+				_vaihe = ENTROPIA;
+				return false;
+			}
+			if (tavu == JPEG_MERKKI)
+				return false;
+			// Scanin data loppui merkkiin (seuraava scan, otsikko tai EOI)
+			_valmiita++;
+			merkki(tavu);
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool JpegSeuraaja::onJpeg()
+{
+	return _vaihe != EI_JPEG && _kohta >= 2;
+}
+
+int JpegSeuraaja::valmiitaScaneja()
+{
+	return _valmiita;
+}
+
+int JpegSeuraaja::scaneja()
+{
+	return _scaneja;
+}
+
+uint32_t JpegSeuraaja::kohta()
+{
+	return _kohta;
+}
@@ -0,0 +1,110 @@
+/*
+* JPEG-rakenteen mukainen paloittelu ja esikatselun seuraaminen
+*
+* JPEG koostuu segmenteistä, jotka alkavat merkillä FF xx. Otsikot
+* (APPn, DQT, DHT, SOFn, DRI) ovat tiedoston alussa ja niitä seuraa yksi
+* (progressiivisessa useampi) scan eli SOS-segmentti ja entropiakoodattu
+* data. Scanin data voi olla jaettu restart-väleihin merkeillä RST0-7,
+* jolloin jokainen väli voidaan purkaa muista riippumatta.
+*
+* Lähetin katkaisee palan viimeiseen sen sisällä olevaan rajaan (segmentin
+* alku tai loppu, restart-välin alku), joten kadonnut pala rikkoo vain omat
+* restart-välinsä. Kuva lähetetään tiedoston järjestyksessä, joten otsikot
+* ja progressiivisen kuvan ensimmäiset (karkeat) scanit menevät ensin ja
+* vastaanotin voi näyttää esikatselun ennen kuin koko kuva on perillä.
+*/
+
+#ifndef JPEG_H
+#define JPEG_H
+
+#include <stdint.h>
+#include "kuvalahde.h"
+
+#define JPEG_MERKKI 0xFF
+#define JPEG_SOI 0xD8
+#define JPEG_EOI 0xD9
+#define JPEG_SOS 0xDA
+#define JPEG_RST0 0xD0
+#define JPEG_RST7 0xD7
+#define JPEG_TEM 0x01
+
+/*
+* Lähetin: etsii lähteestä palojen rajat sitä mukaa kuin paloja kasataan
+*/
+class JpegPaloittelija
+{
+public:
+	JpegPaloittelija();
+
+	// Uusi lähde, palauttaa false (ja paloittelu on pois käytöstä),
+	// jos lähde ei ala JPEG:n SOI-merkillä. Lähde 0 poistaa käytöstä.
+	bool aloita(KuvaLahde* lahde);
+	bool kaytossa();
+
+	// Palan koko kohdasta alku: enintään koko, katkaistu viimeiseen palan
+	// sisällä olevaan rajaan, jos pala ei silloin jää alle pienin byteä
+	int palanKoko(uint32_t alku, int koko, int pienin);
+
+	// Tallennetaan etsinnän tila paluukohdaksi, jos sitä voi käyttää
+	// kohdasta alku. Ryhmä voidaan kasata uudelleen samasta kohdasta
+	// ilman, että kuvaa käydään läpi alusta.
+	void merkitse(uint32_t alku);
+
+private:
+	enum Vaihe { SEGMENTIT, ENTROPIA, LOPPU };
+	struct Tila
+	{
+		Vaihe vaihe;
+		uint32_t kohta;		// tästä jatketaan etsintää
+		uint32_t edellinen;	// viimeisin löydetty raja
+		uint32_t raja;		// seuraava löydetty raja
+	};
+
+	uint32_t seuraavaRaja(uint32_t kohta);
+	uint32_t askel();
+	bool lue(uint32_t kohta, uint8_t* tavu);
+
+	KuvaLahde* _lahde;
+	uint32_t _koko;
+	Tila _nyt;
+	Tila _paluu;
+	bool _paluu_kelpaa;
+	uint8_t _valimuisti[32];
+	uint32_t _valimuistin_alku;
+	int _valimuistissa;
+};
+
+/*
+* Vastaanotin: seuraa järjestyksessä saatua JPEG-dataa byte kerrallaan
+* ja kertoo, kun otsikot ja scanit ovat kokonaan perillä
+*/
+class JpegSeuraaja
+{
+public:
+	JpegSeuraaja();
+
+	void aloita();
+
+	// Seuraava byte, palauttaa true, kun esikatselu voi edetä: otsikot
+	// on saatu (ensimmäinen SOS) tai scan on valmis (seuraava SOS tai EOI)
+	bool lisaa(uint8_t tavu);
+
+	bool onJpeg();
+	int scaneja();			// alkaneet scanit
+	int valmiitaScaneja();	// scanit, joiden data on kokonaan saatu
+	uint32_t kohta();		// seurattujen bytejen määrä
+
+private:
+	enum Vaihe { ALKU_FF, ALKU_SOI, MERKKI, TYYPPI, PITUUS1, PITUUS2, SEGMENTTI, ENTROPIA, ENTROPIA_FF, EI_JPEG };
+
+	bool merkki(uint8_t tyyppi);
+
+	Vaihe _vaihe;
+	uint8_t _tyyppi;
+	uint16_t _jaljella;
+	int _scaneja;
+	int _valmiita;
+	uint32_t _kohta;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#include "katoamisarvio.h"
+
+KatoamisArvio::KatoamisArvio()
+{
+	_katoaminen = 0;
+}
+
+void KatoamisArvio::paketit(int saatuja, int kadonneita)
+{
+	for (int i = 0; i < saatuja; i++)
+		_katoaminen -= _katoaminen >> 3;
+	for (int i = 0; i < kadonneita; i++)
+		_katoaminen += 256 - (_katoaminen >> 3);
+}
+
+uint8_t KatoamisArvio::osuus()
+{
+	uint16_t osuus = _katoaminen >> 3;
+	return osuus > 255 ? 255 : (uint8_t)osuus;
+}
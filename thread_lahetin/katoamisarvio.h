@@ -0,0 +1,31 @@
+/*
+* Pakettien katoamisosuuden arvio
+*
+* Lähetin mittaa katoamisen kuittausten bittikartasta paketeittain, ja
+* sama arvio ohjaa sekä palan kokoa (kokosaadin.h) että ryhmän kokoa ja
+* pariteetteja (fec.h). Arvio on liukuva keskiarvo painolla 1/8 pakettia
+* kohden, joten se seuraa muutoksia muutaman ryhmän viiveellä.
+*/
+
+#ifndef KATOAMISARVIO_H
+#define KATOAMISARVIO_H
+
+#include <stdint.h>
+
+class KatoamisArvio
+{
+public:
+	KatoamisArvio();
+
+	// Kuittaus kertoi saatuja pakettia saaduksi ja kadonneita puuttuvaksi
+	// (kuittauskellon laukeaminen on yksi kadonnut)
+	void paketit(int saatuja, int kadonneita);
+
+	// Katoamisosuus, 0..255 (255 = kaikki katoavat)
+	uint8_t osuus();
+
+private:
+	uint16_t _katoaminen;		// katoamisosuus * 256 * 8
+};
+
+#endif
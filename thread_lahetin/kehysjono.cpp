@@ -0,0 +1,82 @@
+#include "kehysjono.h"
+
+KehysJono::KehysJono()
+{
+	_kirjoitus = 0;
+	_luku = 0;
+	_tyhja = true;
+	_taysi = false;
+	nollaaMittarit();
+}
+
+Kehys* KehysJono::varaa()
+{
+	if (_kirjoitus - _luku >= KEHYSJONO_PAIKKOJA) {
+		// Lasketaan vain siirtymät kasaamisesta odottamiseen
+		if (!_taysi)
+			_taynna++;
+		_taysi = true;
+		return 0;
+	}
+	_taysi = false;
+	return &_paikat[_kirjoitus & (KEHYSJONO_PAIKKOJA - 1)];
+}
+
+void KehysJono::julkaise()
+{
+	// Kehyksen sisältö on kirjoitettu ennen kuin kuluttaja näkee sen
+	__DMB();
+	_kirjoitus = _kirjoitus + 1;
+
+	int syvyys = (int)(_kirjoitus - _luku);
+	if (syvyys > _suurin_syvyys)
+		_suurin_syvyys = syvyys;
+}
+
+Kehys* KehysJono::seuraava()
+{
+	if (_kirjoitus == _luku) {
+		// Lasketaan vain siirtymät lähettämisestä odottamiseen
+		if (!_tyhja)
+			_tyhjenemisia++;
+		_tyhja = true;
+		return 0;
+	}
+	_tyhja = false;
+	__DMB();
+	return &_paikat[_luku & (KEHYSJONO_PAIKKOJA - 1)];
+}
+
+void KehysJono::vapauta()
+{
+	// Kehys on luettu ennen kuin tuottaja saa paikan uudelleen
+	__DMB();
+	_luku = _luku + 1;
+}
+
+int KehysJono::syvyys()
+{
+	return (int)(_kirjoitus - _luku);
+}
+
+int KehysJono::suurinSyvyys()
+{
+	return _suurin_syvyys;
+}
+
+uint32_t KehysJono::tyhjenemisia()
+{
+	return _tyhjenemisia;
+}
+
+uint32_t KehysJono::taynna()
+{
+	return _taynna;
+}
+
+void KehysJono::nollaaMittarit()
+{
+	_suurin_syvyys = 0;
+	_tyhjenemisia = 0;
+	_taynna = 0;
+}
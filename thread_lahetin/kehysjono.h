@@ -0,0 +1,72 @@
+/*
+* Lukoton kehysjono yhdeltä tuottajalta yhdelle kuluttajalle (SPSC)
+*
+* Lähettimen ohjaus (ekaThreadFunction) kasaa lähetettävät paketit
+* suoraan jonon valmiiksi varattuihin paikkoihin ja radiothread
+* (radioThreadFunction) lähettää ne ask-lähettimellä. Kasaaminen ja
+* kuittausten käsittely eivät siten odota lähettimen puskuria.
+*
+* Tuottaja kirjoittaa vain kirjoituslaskuria ja kuluttaja vain
+* lukulaskuria, joten lukkoja ei tarvita. Laskurit kasvavat ympäri
+* pyörähtäen, paikka on laskuri % KEHYSJONO_PAIKKOJA.
+*/
+
+#ifndef KEHYSJONO_H
+#define KEHYSJONO_H
+
+#include "mbed.h"
+#include <stdint.h>
+#include "protokolla.h"
+
+#define KEHYSJONO_PAIKKOJA 8		// 2:n potenssi
+
+#if (KEHYSJONO_PAIKKOJA & (KEHYSJONO_PAIKKOJA - 1))
+#error KEHYSJONO_PAIKKOJA pitää olla 2:n potenssi
+#endif
+
+struct Kehys
+{
+	uint8_t osoite;					// vastaanottimen osoite
+	uint8_t koko;					// paketin koko (byteä)
+	int8_t data[MAX_MESSAGE_SIZE];
+};
+
+class KehysJono
+{
+public:
+	KehysJono();
+
+	// Tuottaja: vapaa paikka kasattavaksi tai 0, jos jono on täynnä
+	Kehys* varaa();
+
+	// Tuottaja: varattu paikka on kasattu ja siirtyy jonoon
+	void julkaise();
+
+	// Kuluttaja: seuraava lähetettävä kehys tai 0, jos jono on tyhjä
+	Kehys* seuraava();
+
+	// Kuluttaja: kehys on lähetetty, paikka vapautuu
+	void vapauta();
+
+	// Jonossa olevien kehysten määrä
+	int syvyys();
+
+	// Mittarit jonon tyhjenemisen (radio jää odottamaan) ja
+	// täyttymisen (tuottaja joutuu odottamaan) seuraamiseen
+	int suurinSyvyys();
+	uint32_t tyhjenemisia();
+	uint32_t taynna();
+	void nollaaMittarit();
+
+private:
+	Kehys _paikat[KEHYSJONO_PAIKKOJA];
+	volatile uint32_t _kirjoitus;
+	volatile uint32_t _luku;
+	volatile int _suurin_syvyys;
+	volatile uint32_t _tyhjenemisia;
+	volatile uint32_t _taynna;
+	bool _tyhja;					// kuluttaja: edellinen haku oli tyhjä
+	bool _taysi;					// tuottaja: edellinen varaus epäonnistui
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "kokoaja.h"
+
+#define KOKOAJA_MASKI (KOKOAJA_IKKUNA - 1)
+
+Kokoaja::Kokoaja()
+{
+	aloita(0, 0);
+}
+
+void Kokoaja::aloita(Ulos ulos, void* konteksti)
+{
+	_ulos = ulos;
+	_konteksti = konteksti;
+	_valmis = 0;
+	_suurin = 0;
+	_loppu = 0;
+	_loppu_tiedossa = false;
+	_kokonaan = false;
+	for (int i = 0; i < KOKOAJA_IKKUNA / 32; i++)
+		_bitit[i] = 0;
+}
+
+bool Kokoaja::saatu(uint32_t kohta)
+{
+	uint32_t i = kohta & KOKOAJA_MASKI;
+	return _bitit[i >> 5] & ((uint32_t)1 << (i & 31));
+}
+
+bool Kokoaja::lisaa(uint32_t alku, const uint8_t* pala, int koko, bool viimeinen)
+{
+	if (_kokonaan)
+		return false;
+
+	for (int j = 0; j < koko; j++) {
+		uint32_t kohta = alku + j;
+		// Jo annettu eteenpäin tai ikkunan ulkopuolella
+		if (kohta < _valmis || kohta >= _valmis + KOKOAJA_IKKUNA)
+			continue;
+		uint32_t i = kohta & KOKOAJA_MASKI;
+		_puskuri[i] = pala[j];
+		_bitit[i >> 5] |= (uint32_t)1 << (i & 31);
+		if (kohta + 1 > _suurin)
+			_suurin = kohta + 1;
+	}
+	if (viimeinen) {
+		_loppu = alku + koko;
+		_loppu_tiedossa = true;
+	}
+
+	toimita();
+
+	if (_loppu_tiedossa && _valmis >= _loppu) {
+		_kokonaan = true;
+		return true;
+	}
+	return false;
+}
+
+void Kokoaja::toimita()
+{
+	// Annetaan yhtenäinen alku käsittelijälle, rengaspuskurin
+	// lopussa kahdessa osassa
+	while (saatu(_valmis)) {
+		uint32_t i = _valmis & KOKOAJA_MASKI;
+		int koko = 0;
+		while (i + koko < KOKOAJA_IKKUNA && saatu(_valmis + koko)) {
+			uint32_t b = i + koko;
+			_bitit[b >> 5] &= ~((uint32_t)1 << (b & 31));
+			koko++;
+		}
+		if (_ulos)
+			_ulos(_valmis, &_puskuri[i], koko, _konteksti);
+		_valmis += koko;
+	}
+}
+
+uint32_t Kokoaja::valmis()
+{
+	return _valmis;
+}
+
+int Kokoaja::vapaa()
+{
+	uint32_t kaytossa = _suurin > _valmis ? _suurin - _valmis : 0;
+	return KOKOAJA_IKKUNA - (int)kaytossa;
+}
@@ -0,0 +1,64 @@
+/*
+* Vastaanotetun datan kokoaja
+*
+* Paketit voivat tulla missä järjestyksessä tahansa (ryhmän paketit,
+* pariteetilla korjatut ja uudelleenlähetetyt). Kokoaja pitää
+* saapuneet bytet rengaspuskurissa ja bittikartassa ja antaa datan
+* käsittelijälle järjestyksessä heti, kun yhtenäinen pala alusta asti on
+* saatu, joten datan purku ja tarkistus etenevät vastaanoton aikana.
+*
+* Ikkunan pitää olla vähintään yhden ryhmän kokoinen, koska lähetin
+* siirtyy seuraavaan ryhmään vasta, kun koko ryhmä on kuitattu.
+*/
+
+#ifndef KOKOAJA_H
+#define KOKOAJA_H
+
+#include <stdint.h>
+#include "protokolla.h"
+#include "fec.h"
+
+#define KOKOAJA_IKKUNA 2048		// 2:n potenssi
+
+#if KOKOAJA_IKKUNA < FEC_MAX_K * MAX_PACKET_DATA_SIZE || (KOKOAJA_IKKUNA & (KOKOAJA_IKKUNA - 1))
+#error KOKOAJA_IKKUNA pitää olla 2:n potenssi ja vähintään ryhmän kokoinen
+#endif
+
+class Kokoaja
+{
+public:
+	// Järjestyksessä oleva data annetaan tälle funktiolle
+	typedef void (*Ulos)(uint32_t alku, const uint8_t* data, int koko, void* konteksti);
+
+	Kokoaja();
+
+	// Uusi siirto alkaa kohdasta 0
+	void aloita(Ulos ulos, void* konteksti);
+
+	// Lisätään pala kohtaan alku, viimeinen = palassa on siirron viimeinen byte.
+	// Jo saadut bytet ohitetaan. Palauttaa true, kun siirron viimeinenkin
+	// byte on annettu käsittelijälle.
+	bool lisaa(uint32_t alku, const uint8_t* pala, int koko, bool viimeinen);
+
+	// Järjestyksessä käsittelijälle annettujen bytejen määrä
+	uint32_t valmis();
+
+	// Montako byteä ikkunaan mahtuu vielä kauimmaisen saadun byten jälkeen
+	int vapaa();
+
+private:
+	bool saatu(uint32_t kohta);
+	void toimita();
+
+	Ulos _ulos;
+	void* _konteksti;
+	uint32_t _valmis;
+	uint32_t _suurin;		// kauimmaisen ikkunaan saadun byten jälkeinen kohta
+	uint32_t _loppu;
+	bool _loppu_tiedossa;
+	bool _kokonaan;
+	uint8_t _puskuri[KOKOAJA_IKKUNA];
+	uint32_t _bitit[KOKOAJA_IKKUNA / 32];
+};
+
+#endif
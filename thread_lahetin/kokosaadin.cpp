@@ -0,0 +1,52 @@
+#include "kokosaadin.h"
+
+// Palan kasvatus ja pienennys
+#define KASVATUS 8					// byteä kerrallaan
+#define KASVATUS_KUITTAUKSIA 4		// näin monen peräkkäin saadun paketin jälkeen
+
+// Katoamisosuuden rajat (256 = kaikki katoavat)
+#define KASVATUS_RAJA 13			// alle 5 %: palaa voi kasvattaa
+#define PIENENNYS_RAJA 38			// yli 15 %: palaa pienennetään
+
+KokoSaadin::KokoSaadin(int pienin, int suurin, KatoamisArvio* katoaminen)
+{
+	_pienin = pienin;
+	_suurin = suurin;
+	_koko = suurin;		// oletetaan aluksi, että yhteys on hyvä
+	_katoaminen = katoaminen;
+	_perakkain = 0;
+}
+
+int KokoSaadin::koko()
+{
+	return _koko;
+}
+
+void KokoSaadin::paketit(int saatuja, int kadonneita)
+{
+	// Pienennetään reilusti, kun paketteja katoaa: pienempi pala
+	// menee todennäköisemmin perille ja uudelleenlähetys on halvempi.
+	// Yksi kuittaus pienentää vain kerran, vaikka siitä puuttuisi monta
+	// pakettia.
+	if (kadonneita) {
+		_perakkain = 0;
+		if (_katoaminen->osuus() > PIENENNYS_RAJA) {
+			_koko = _koko * 3 / 4;
+			if (_koko < _pienin)
+				_koko = _pienin;
+		}
+		return;
+	}
+
+	_perakkain += saatuja;
+	if (_perakkain < KASVATUS_KUITTAUKSIA)
+		return;
+	_perakkain = 0;
+
+	// Kasvatetaan varovasti, kun paketit menevät perille
+	if (_katoaminen->osuus() < KASVATUS_RAJA) {
+		_koko += KASVATUS;
+		if (_koko > _suurin)
+			_koko = _suurin;
+	}
+}
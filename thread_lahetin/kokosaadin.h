@@ -0,0 +1,39 @@
+/*
+* Lähetettävän palan koon säädin
+*
+* Häiriöttömällä yhteydellä kannattaa lähettää mahdollisimman isoja
+* paloja, koska jokaisesta paketista maksetaan alkutahdistus, header,
+* CRC ja kuittaus. Häiriöisellä yhteydellä iso paketti katoaa
+* todennäköisemmin ja sen uudelleenlähetys maksaa enemmän, joten
+* palaa pienennetään, kun paketteja katoaa.
+*/
+
+#ifndef KOKOSAADIN_H
+#define KOKOSAADIN_H
+
+#include <stdint.h>
+#include "katoamisarvio.h"
+
+class KokoSaadin
+{
+public:
+	KokoSaadin(int pienin, int suurin, KatoamisArvio* katoaminen);
+
+	// Seuraavan lähetettävän palan koko (byteä)
+	int koko();
+
+	// Kutsutaan jokaisen kuittauksen (tai kuittauskellon laukeamisen)
+	// jälkeen, kun katoamisarvio on jo päivitetty samoilla luvuilla:
+	// montako lähetettyä pakettia kuittaus kertoi saaduksi ja montako
+	// puuttui. Palan kokoa muutetaan enintään kerran.
+	void paketit(int saatuja, int kadonneita);
+
+private:
+	int _koko;
+	int _pienin;
+	int _suurin;
+	KatoamisArvio* _katoaminen;
+	uint8_t _perakkain;
+};
+
+#endif
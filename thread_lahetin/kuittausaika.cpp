@@ -0,0 +1,78 @@
+#include "kuittausaika.h"
+
+#define RTO_G 20			// pienin lisäys vaihtelulle (ms), mittauksen tarkkuus
+#define RTO_MIN 100
+#define RTO_MAX 30000
+#define RTO_MAX_KERROIN 16
+
+KuittausAika::KuittausAika(int bittinopeus)
+{
+	_mitattu = false;
+	_srtt8 = 0;
+	_rttvar4 = 0;
+	_kerroin = 1;
+	asetaNopeus(bittinopeus);
+}
+
+void KuittausAika::asetaNopeus(int bittinopeus)
+{
+	_nopeus = bittinopeus > 0 ? bittinopeus : 1;
+}
+
+int KuittausAika::bitteja(int koko)
+{
+	return ASK_JOHDANTO_BITIT + (ASK_PACKET_OVERHEAD + koko) * ASK_BITTIA_TAVULLE;
+}
+
+int KuittausAika::ilmaaika(int bitit)
+{
+	return (int)((int64_t)bitit * 1000 / _nopeus);
+}
+
+int KuittausAika::rto(int bitit)
+{
+	int malli = ilmaaika(bitit);
+	int odotus;
+
+	// Ennen ensimmäistä mittausta ylimääräisen viiveen oletetaan olevan
+	// yhtä suuri kuin ilmassaoloaika
+	if (!_mitattu)
+		odotus = 2 * malli;
+	else
+		odotus = malli + (_srtt8 >> 3) + (_rttvar4 > RTO_G ? _rttvar4 : RTO_G);
+
+	odotus *= _kerroin;
+	if (odotus < RTO_MIN)
+		odotus = RTO_MIN;
+	if (odotus > RTO_MAX)
+		odotus = RTO_MAX;
+	return odotus;
+}
+
+void KuittausAika::mittaus(int rtt, int bitit)
+{
+	int viive = rtt - ilmaaika(bitit);
+	if (viive < 0)
+		viive = 0;
+
+	if (!_mitattu) {
+		_srtt8 = viive << 3;
+		_rttvar4 = viive << 1;
+		_mitattu = true;
+	}
+	else {
+		// srtt += (viive - srtt) / 8, rttvar += (|viive - srtt| - rttvar) / 4
+		int ero = viive - (_srtt8 >> 3);
+		_srtt8 += ero;
+		if (ero < 0)
+			ero = -ero;
+		_rttvar4 += ero - (_rttvar4 >> 2);
+	}
+	_kerroin = 1;
+}
+
+void KuittausAika::laukesi()
+{
+	if (_kerroin < RTO_MAX_KERROIN)
+		_kerroin *= 2;
+}
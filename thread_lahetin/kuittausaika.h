@@ -0,0 +1,57 @@
+/*
+* Uudelleenlähetyksen odotusaika (RTO) mitatuista kiertoajoista
+*
+* Lähetyksen ja sen kuittauksen ilmassaoloaika lasketaan bittinopeudesta:
+* ask-lähetin lähettää jokaisesta bytestä kaksi kuuden bitin symbolia
+* (12 bittiä) ja jokaisen paketin alussa on johdanto ja aloitussymboli.
+* Mitatusta kiertoajasta vähennetään laskettu ilmassaoloaika ja
+* jäljelle jäävälle viiveelle (käsittely, tulostus, säikeiden vaihto)
+* lasketaan Jacobsonin/Karelsin liukuva keskiarvo ja vaihtelu.
+* Odotusaika on ilmassaoloaika + keskiarvo + 4 * vaihtelu, joten se
+* seuraa paketin kokoa ja bittinopeuden muutosta heti.
+*
+* Uudelleenlähetetyn paketin kiertoaikaa ei mitata (Karnin algoritmi),
+* koska ei tiedetä, kumpaan lähetykseen kuittaus kuuluu. Kuittauskellon
+* laukeaminen kaksinkertaistaa odotusajan seuraavaan mittaukseen asti.
+*/
+
+#ifndef KUITTAUSAIKA_H
+#define KUITTAUSAIKA_H
+
+#include <stdint.h>
+#include "protokolla.h"
+
+#define ASK_JOHDANTO_BITIT 48		// johdanto ja aloitussymboli, 8 kuuden bitin symbolia
+#define ASK_BITTIA_TAVULLE 12
+
+class KuittausAika
+{
+public:
+	KuittausAika(int bittinopeus);
+
+	void asetaNopeus(int bittinopeus);
+
+	// Paketin, jossa on koko byteä viestiä, bittien määrä radiolla
+	static int bitteja(int koko);
+
+	// Bittien ilmassaoloaika (ms)
+	int ilmaaika(int bitit);
+
+	// Odotusaika (ms) lähetykselle, jonka paketeissa ja kuittauksessa on bitit bittiä
+	int rto(int bitit);
+
+	// Kuitattu ensimmäisellä lähetyksellä, kiertoaika rtt (ms)
+	void mittaus(int rtt, int bitit);
+
+	// Kuittauskello laukesi
+	void laukesi();
+
+private:
+	int _nopeus;
+	bool _mitattu;
+	int _srtt8;			// ylimääräisen viiveen keskiarvo * 8 (ms)
+	int _rttvar4;		// ylimääräisen viiveen vaihtelu * 4 (ms)
+	int _kerroin;		// peräkkäisten laukeamisten kaksinkertaistus
+};
+
+#endif
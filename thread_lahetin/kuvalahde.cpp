@@ -0,0 +1,172 @@
+#include "kuvalahde.h"
+#include "ask_CRC32.h"
+#include <string.h>
+
+#if !defined(__MBED__) && (defined(__unix__) || defined(__APPLE__))
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Paljonko lähteestä voi lukea kohdasta alku, kun pyydetään maara byteä
+static int luettavissa(uint32_t koko, uint32_t alku, int maara)
+{
+	if (maara < 0)
+		return -1;
+	if (alku >= koko)
+		return 0;
+	if ((uint32_t)maara > koko - alku)
+		return (int)(koko - alku);
+	return maara;
+}
+
+MuistiLahde::MuistiLahde(const void* data, uint32_t koko)
+{
+	_data = (const uint8_t*)data;
+	_koko = koko;
+}
+
+uint32_t MuistiLahde::koko()
+{
+	return _koko;
+}
+
+int MuistiLahde::lue(uint32_t alku, uint8_t* kohde, int maara)
+{
+	maara = luettavissa(_koko, alku, maara);
+	if (maara > 0)
+		memcpy(kohde, &_data[alku], maara);
+	return maara;
+}
+
+const uint8_t* MuistiLahde::osoite()
+{
+	return _data;
+}
+
+#if defined(__MBED__)
+LohkoLahde::LohkoLahde(BlockDevice* laite, bd_addr_t alku, uint32_t koko)
+{
+	_laite = laite;
+	_alku = alku;
+	_koko = koko;
+	_puskuri_kelpaa = false;
+	_puskurin_osoite = 0;
+}
+
+uint32_t LohkoLahde::koko()
+{
+	return _koko;
+}
+
+int LohkoLahde::lue(uint32_t alku, uint8_t* kohde, int maara)
+{
+	maara = luettavissa(_koko, alku, maara);
+	bd_size_t lohko = _laite->get_read_size();
+	if (maara > 0 && (lohko == 0 || lohko > LOHKOLAHDE_PUSKURI))
+		return -1;
+
+	// Laitteelta voi lukea vain lukukoon kokoisia lohkoja, joten luetaan
+	// palan kattavat lohkot välimuistiin yksi kerrallaan. Peräkkäiset
+	// palat osuvat yleensä samaan lohkoon.
+	int luettu = 0;
+	while (luettu < maara) {
+		bd_addr_t osoite = _alku + alku + luettu;
+		bd_addr_t lohkon_alku = osoite - osoite % lohko;
+		if (!_puskuri_kelpaa || _puskurin_osoite != lohkon_alku) {
+			_puskuri_kelpaa = false;
+			if (_laite->read(_puskuri, lohkon_alku, lohko) != 0)
+				return -1;
+			_puskurin_osoite = lohkon_alku;
+			_puskuri_kelpaa = true;
+		}
+		int kohta = (int)(osoite - lohkon_alku);
+		int pala = (int)lohko - kohta;
+		if (pala > maara - luettu)
+			pala = maara - luettu;
+		memcpy(&kohde[luettu], &_puskuri[kohta], pala);
+		luettu += pala;
+	}
+	return luettu;
+}
+#endif
+
+#if !defined(__MBED__) && (defined(__unix__) || defined(__APPLE__))
+TiedostoLahde::TiedostoLahde()
+{
+	_data = 0;
+	_koko = 0;
+}
+
+TiedostoLahde::~TiedostoLahde()
+{
+	sulje();
+}
+
+bool TiedostoLahde::avaa(const char* polku)
+{
+	sulje();
+	int tiedosto = open(polku, O_RDONLY);
+	if (tiedosto < 0)
+		return false;
+
+	// Kartoitus pysyy voimassa, vaikka tiedosto suljetaan
+	struct stat tiedot;
+	bool onnistui = false;
+	if (fstat(tiedosto, &tiedot) == 0 && tiedot.st_size > 0 && (uint64_t)tiedot.st_size <= 0xFFFFFFFF) {
+		void* kartta = mmap(0, (size_t)tiedot.st_size, PROT_READ, MAP_PRIVATE, tiedosto, 0);
+		if (kartta != MAP_FAILED) {
+			_data = (const uint8_t*)kartta;
+			_koko = (uint32_t)tiedot.st_size;
+			onnistui = true;
+		}
+	}
+	close(tiedosto);
+	return onnistui;
+}
+
+void TiedostoLahde::sulje()
+{
+	if (_data)
+		munmap((void*)_data, _koko);
+	_data = 0;
+	_koko = 0;
+}
+
+uint32_t TiedostoLahde::koko()
+{
+	return _koko;
+}
+
+int TiedostoLahde::lue(uint32_t alku, uint8_t* kohde, int maara)
+{
+	maara = luettavissa(_koko, alku, maara);
+	if (maara > 0)
+		memcpy(kohde, &_data[alku], maara);
+	return maara;
+}
+
+const uint8_t* TiedostoLahde::osoite()
+{
+	return _data;
+}
+#endif
+
+uint32_t lahteenCrc32(KuvaLahde* lahde)
+{
+	if (lahde->osoite())
+		return CRC32::compute(lahde->osoite(), lahde->koko());
+
+	uint8_t pala[64];
+	uint32_t crc = CRC32::begin();
+	uint32_t alku = 0;
+	while (alku < lahde->koko()) {
+		int luettu = lahde->lue(alku, pala, sizeof(pala));
+		if (luettu <= 0)
+			break;
+		crc = CRC32::update(crc, pala, luettu);
+		alku += luettu;
+	}
+	return CRC32::complete(crc);
+}
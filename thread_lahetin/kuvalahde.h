@@ -0,0 +1,105 @@
+/*
+* Lähetettävän kuvan lähde
+*
+* Lähetin lukee kuvaa palan kerrallaan kohdasta alku, joten koko kuvan
+* ei tarvitse olla muistissa eikä sen koko ole sidottu RAM:in kokoon.
+* Toteutukset:
+* 	MuistiLahde		taulukko flashissa tai RAM:issa (pakattu_kuva.h)
+* 	LohkoLahde		mbed:in BlockDevice (SD-kortti, ulkoinen flash),
+* 					luetaan laitteen lukukoon lohkoina välimuistin kautta
+* 	TiedostoLahde	vain host-käännöksissä: muistiin kartoitettu tiedosto
+*
+* Jos lähde on suoraan muistissa (osoite() != 0), kuva voidaan pakata
+* kerralla, muuten se lähetetään pakkaamattomana.
+*/
+
+#ifndef KUVALAHDE_H
+#define KUVALAHDE_H
+
+#include <stdint.h>
+
+#if defined(__MBED__)
+#include "BlockDevice.h"
+#endif
+
+// LohkoLahteen välimuisti, laitteen lukukoko ei saa olla tätä suurempi
+#ifndef LOHKOLAHDE_PUSKURI
+#define LOHKOLAHDE_PUSKURI 512
+#endif
+
+class KuvaLahde
+{
+public:
+	virtual ~KuvaLahde() {}
+
+	// Kuvan koko byteinä
+	virtual uint32_t koko() = 0;
+
+	// Luetaan enintään maara byteä kohdasta alku kohteeseen, palauttaa
+	// luettujen bytejen määrän (kuvan lopussa vähemmän) tai -1 virheessä
+	virtual int lue(uint32_t alku, uint8_t* kohde, int maara) = 0;
+
+	// Kuvan alku, jos koko kuva on suoraan muistissa, muuten 0
+	virtual const uint8_t* osoite() { return 0; }
+};
+
+class MuistiLahde : public KuvaLahde
+{
+public:
+	MuistiLahde(const void* data, uint32_t koko);
+
+	uint32_t koko();
+	int lue(uint32_t alku, uint8_t* kohde, int maara);
+	const uint8_t* osoite();
+
+private:
+	const uint8_t* _data;
+	uint32_t _koko;
+};
+
+#if defined(__MBED__)
+class LohkoLahde : public KuvaLahde
+{
+public:
+	// Kuva on laitteella kohdassa alku ja sen koko on koko.
+	// Laite pitää olla alustettu (init) ennen ensimmäistä lukua.
+	LohkoLahde(BlockDevice* laite, bd_addr_t alku, uint32_t koko);
+
+	uint32_t koko();
+	int lue(uint32_t alku, uint8_t* kohde, int maara);
+
+private:
+	BlockDevice* _laite;
+	bd_addr_t _alku;
+	uint32_t _koko;
+	bool _puskuri_kelpaa;
+	bd_addr_t _puskurin_osoite;	// välimuistissa olevan lohkon osoite laitteella
+	uint8_t _puskuri[LOHKOLAHDE_PUSKURI];
+};
+#endif
+
+#if !defined(__MBED__) && (defined(__unix__) || defined(__APPLE__))
+class TiedostoLahde : public KuvaLahde
+{
+public:
+	TiedostoLahde();
+	~TiedostoLahde();
+
+	// Kartoitetaan tiedosto muistiin, palauttaa false, jos sitä ei voi avata
+	bool avaa(const char* polku);
+	void sulje();
+
+	uint32_t koko();
+	int lue(uint32_t alku, uint8_t* kohde, int maara);
+	const uint8_t* osoite();
+
+private:
+	const uint8_t* _data;
+	uint32_t _koko;
+};
+#endif
+
+// CRC-32 koko lähteestä, luetaan pieninä paloina
+uint32_t lahteenCrc32(KuvaLahde* lahde);
+
+#endif
@@ -19,150 +19,751 @@
 	uint8_t transmitter_received_transmitter_address = 0;
 	
 
-#define PACKET_DATA_SIZE 50
-#define HEADER_SIZE 2
-#define PACKET_SIZE PACKET_DATA_SIZE+HEADER_SIZE
+#include "ask_CRC32.h"
+#include "protokolla.h"
+#include "kokosaadin.h"
+#include "pakkaus.h"
+#include "fec.h"
+#include "suihkulahde.h"
+#include "kuittausaika.h"
+#include "kehysjono.h"
+#include "kuvalahde.h"
+#include "jpeg.h"
+#include "monilahetys.h"
+#include "jaljitys.h"
+
+// Kuvan pakkausmenetelmä (pakkaus.h), PAKKAUS_EI lähettää kuvan sellaisenaan
+#define PAKKAUSMENETELMA PAKKAUS_LZ77
+
+// 1: kuva lähetetään kaikille vastaanottimille suihkulähdekoodattuna
+// ilman kuittauksia (suihkulahde.h), 0: kuitattu siirto yhdelle vastaanottimelle
+#define YLEISLAHETYS 0
+#define YLEISLAHETYS_TIETOVALI 8		// tietopaketti näin monen symbolin välein
+
+// 1: kuva lähetetään kaikille vastaanottimille ryhmäosoitteeseen, ja
+// vastaanottimet pyytävät vain puuttuvat palat (monilahetys.h)
+#define MONILAHETYS 0
+#define MONI_HILJAISIA 3				// siirto päättyy, kun näin moneen kierrokseen ei tule NACKeja
+#define MONI_KASITTELYAIKA 200			// ms, korjausikkunaan lisätään vastaanottimien käsittelyaika
+
+// 1: pakkaamaton JPEG-kuva paloitellaan merkkien ja restart-välien
+// kohdalta (jpeg.h), 0: aina palan koon mukaan
+#define JPEG_PALOITTELU 1
 
 
 Timer kuittauskello1;
-int8_t message[PACKET_SIZE];		// message[] = paketti
-uint16_t offset = 0;
+KehysJono kehysjono1;				// ekalta threadilta radiothreadille (kehysjono.h)
+int8_t message[MAX_MESSAGE_SIZE];	// message[] = paketti
+uint32_t offset = 0;
+KatoamisArvio pakettien_katoaminen;	// yhteinen arvio palan koon ja FEC:n säätimille
+KokoSaadin palan_koko(MIN_PACKET_DATA_SIZE, MAX_PACKET_DATA_SIZE, &pakettien_katoaminen);
+KuittausAika kuittausaika(BITTINOPEUS);
+int lahetyksen_bitit = 0;			// lähetyksen pakettien ja kuittauksen bitit radiolla
+bool tiedot_kuitattu = false;		// onko tietopaketti (kuvan koko ja tarkiste) kuitattu
+
+// Vastaanottimen viimeksi kertoma ikkuna (protokolla.h): montako byteä
+// dataa se ottaa vastaan kuitatun kohdan jälkeen
+#define IKKUNA_EI_TIEDOSSA 0xFFFF
+#define IKKUNA_ODOTUS 2000			// ms, nollaikkunassa odotetaan näin kauan ikkunapäivitystä
+uint16_t vastaanottajan_ikkuna = IKKUNA_EI_TIEDOSSA;
+
+// Lähetettävä kuva luetaan lähteestä palan kerrallaan (kuvalahde.h).
+// Oletuksena table-taulukko (pakattu_kuva.h) flashista, esimerkiksi
+// SD-kortilta lähetettäessä:
+// 	SDBlockDevice sd(D11, D12, D13, D10);
+// 	LohkoLahde sd_kuva(&sd, 0, kuvan_koko_byteina);
+// 	KuvaLahde * kuva = &sd_kuva;		// ja sd.init() ennen pakkaaKuva()
+MuistiLahde flash_kuva(table, sizeof(table));
+KuvaLahde * kuva = &flash_kuva;
+uint32_t viestin_koko = 0;			// kuvan koko byteinä
+uint32_t viestin_crc = 0;			// kuvan CRC-32 tietopakettiin
 
-int viestin_koko = sizeof(table);	// table-taulukon (pakattu_kuva.h) koko
-									// byteinä, koska taulukon alkiot on
-									// int8_t eli 8 bittisiä, kertoo myös alkioiden
-									// määrän
+// Pakattu kuva, käytetään vain jos kuva on suoraan muistissa ja
+// pakattu on pienempi kuin alkuperäinen ja mahtuu puskuriin
+#define PAKKAUSPUSKURI 2048
+uint8_t pakattu[PAKKAUSPUSKURI];
+MuistiLahde pakattu_kuva(pakattu, 0);
+Pakkaus pakkaus = PAKKAUS_EI;
+KuvaLahde * lahetettava = kuva;		// paketoitava data
+uint32_t lahetettava_koko = 0;
+JpegPaloittelija jpeg_paloittelu;
+
+
+void pakkaaKuva()
+{
+	// Pakataan kuva ennen siirtoa. Jos pakkaus ei pienennä kuvaa tai
+	// kuva ei ole kokonaan muistissa, lähetetään kuva sellaisenaan
+	// suoraan lähteestä.
+	viestin_koko = kuva->koko();
+	viestin_crc = lahteenCrc32(kuva);
+	pakkaus = PAKKAUS_EI;
+	lahetettava = kuva;
+	lahetettava_koko = viestin_koko;
+
+	if (PAKKAUSMENETELMA != PAKKAUS_EI && kuva->osoite() && viestin_koko <= PAKKAUSPUSKURI) {
+		int koko = pakkaa(PAKKAUSMENETELMA, kuva->osoite(), viestin_koko, pakattu, sizeof(pakattu));
+		if (koko > 0 && (uint32_t)koko < viestin_koko) {
+			pakkaus = PAKKAUSMENETELMA;
+			pakattu_kuva = MuistiLahde(pakattu, koko);
+			lahetettava = &pakattu_kuva;
+			lahetettava_koko = koko;
+		}
+	}
+	jaljita(J1_PAKKAUS, pakkaus, viestin_koko, lahetettava_koko,
+		viestin_koko ? (uint32_t)(100 * (uint64_t)lahetettava_koko / viestin_koko) : 0);
+
+	// Pakattua dataa ei voi paloitella JPEG:n rakenteen mukaan
+	if (jpeg_paloittelu.aloita(JPEG_PALOITTELU && pakkaus == PAKKAUS_EI ? lahetettava : 0))
+		jaljita(J1_JPEG_PALOITTELU);
+}
+
+
+// FEC-ryhmä (fec.h) valmiiksi kasattuina paketteina: datapaketit ja
+// pariteetit. Ryhmiä on kaksi, jotta seuraava ryhmä voidaan kasata, kun
+// edellisen viimeinen paketti on vielä lähettimen puskurissa ja sen
+// kuittausta odotetaan. Kuittauksen jälkeen seuraava ryhmä voidaan
+// lähettää heti.
+struct Lahetysryhma
+{
+	int8_t kehys[FEC_MAX_K + FEC_MAX_P][MAX_MESSAGE_SIZE];
+	int k;						// datapaketit kehys[0..k-1]
+	int p;						// pariteetit kehys[k..k+p-1]
+	uint32_t loppu;				// ryhmän jälkeisen palan alkukohta
+	bool kasattu;
+	// Säätimien arvot kasattaessa, ryhmä kasataan uudelleen, jos ne ovat
+	// muuttuneet ennen kuin ryhmää on lähetetty
+	int pyydetty_koko;
+	int pyydetty_k;
+	int pyydetty_p;
+};
+Lahetysryhma ryhmat[2];
+Lahetysryhma * ryhma1 = &ryhmat[0];		// lähetettävä ryhmä
+Lahetysryhma * seuraava1 = &ryhmat[1];	// kuittausta odotettaessa kasattu seuraava ryhmä
+uint8_t seq = 0;				// ryhmän ensimmäisen paketin järjestysnumero, ei nollaudu
+								// siirtojen välissä, jotta vanhat kuittaukset tunnistetaan
+uint16_t ryhman_saadut = 0;		// vastaanottimen kuittaamat ryhmän paketit (bitti i = paketti i)
+uint16_t ryhman_lahetetyt = 0;	// viimeksi lähetetyt ryhmän datapaketit (bitti i = paketti i)
+bool ryhma_lahetetty = false;	// ryhmä on lähetetty ainakin kerran
+bool ryhma_uudelleen = false;	// ryhmää on jo lähetetty uudelleen
+bool tietopaketti_uudelleen = false;
+bool seuraava_epaonnistui = false;	// seuraavan ryhmän kasaaminen epäonnistui, ei yritetä uudelleen odotettaessa
+FecSaadin fec(&pakettien_katoaminen);
+
+enum Kuittaus { EI_KUITTAUSTA, KUITATTU, PUUTTUU };
+
+
+int kasaaTietopaketti()
+{
+	// Tietopaketissa kerrotaan vastaanottimelle kuvan koko ja koko kuvan
+	// CRC-32, jotta vastaanotin voi tarkistaa kootun kuvan (protokolla.h)
+	message[0] = HEADER_INFO_FLAG;
+	message[1] = INFO_DATA_SIZE;
+	kirjoitaU16(&message[2], 0);
+	message[4] = seq;		// ensimmäisen datapaketin järjestysnumero
+	message[5] = 0;
+	kirjoitaU32(&message[HEADER_SIZE], viestin_koko);
+	kirjoitaU32(&message[HEADER_SIZE + 4], viestin_crc);
+	message[HEADER_SIZE + 8] = pakkaus;
+	kirjoitaU32(&message[HEADER_SIZE + 9], lahetettava_koko);
 
+	return HEADER_SIZE + INFO_DATA_SIZE;
+}
 
-void kasaaPaketti(int ptr)
+int kasaaPaketti(int8_t* kohde, uint32_t ptr, int koko, uint8_t numero)
 {	
-	/********************************************************
-	 * Headerin (2 byteä) rakenne:
-	 * 
-	 * 			message[0]					  message[1]
-	 * 0 0 0 0 0 0 0 0   |    0 0 0 0 0 0 0 0 
-	 * 	 | |---------|	      |-------------|
-	 * 	 |		|				 * datan koko (int8_t, <128)
-	 * 	 |		 \
-	 * 	 |		   * paketin järjestysnumero (6 byteä, <64)
-	 *   | 			 (tiedetään, että paketteja on tässä tapauksessa vähemmän)
-	 * 	  \
-	 * 	   * viimeisen paketin lippu, 1 viimeisessä paketissa
-	*/
-
-	// Otetaan paketin alkukohta erilliseen muuttujaan muistiin
-	uint8_t paketti_startptr = ptr;
-
-	// Headerin ensimmäiseen tavuun paketin järjestysnumero
-	message[0] = 0x00 + ( ptr / PACKET_DATA_SIZE );
-
-	// Kasataan paketin dataosio
-	for(int i = 0;i<PACKET_DATA_SIZE;i++)
+	// Headerin rakenne on kuvattu tiedostossa protokolla.h.
+	// Alkukohdasta lähetetään alimmat 16 bittiä, vastaanotin päättelee
+	// ylemmät bitit, koska lähetin on enintään ryhmän verran edellä.
+
+	// Kasataan paketin dataosio lähteestä, viimeinen pala on niin
+	// pitkä kuin dataa on jäljellä. JPEG-kuvan pala päättyy merkkiin.
+	// Jos lähteestä ei saada koko palaa, palautetaan -1: tyhjä pala ei
+	// siirtäisi alkukohtaa eteenpäin.
+	koko = jpeg_paloittelu.palanKoko(ptr, koko, MIN_PACKET_DATA_SIZE);
+	if ((uint32_t)koko > lahetettava_koko - ptr)
+		koko = (int)(lahetettava_koko - ptr);
+	if (lahetettava->lue(ptr, (uint8_t *)&kohde[HEADER_SIZE], koko) != koko) {
+		jaljita(J1_LUKUVIRHE_KOHDASSA, ptr);
+		return -1;
+	}
+
+	kohde[0] = 0x00;
+	kohde[1] = koko;
+	kirjoitaU16(&kohde[2], (uint16_t)ptr);
+	kohde[4] = numero;
+	kohde[5] = 0;			// ryhmän tiedot täytetään, kun ryhmä on kasattu
+
+	// Jos koko (pakattu) table-taulu (pakattu_kuva.h) on nyt paketoitu,
+	// laitetaan lippu merkiksi viimeisestä paketista
+	if ( ptr + koko >= lahetettava_koko ) {
+		kohde[0] |= HEADER_LAST_FLAG;
+	}
+
+	return HEADER_SIZE + koko;
+}
+
+int ryhmanPala(int p)
+{
+	// Jos pariteetteja lähetetään, palan pitää olla sen verran pienempi,
+	// että pariteetti mahtuu viestiin
+	int koko = palan_koko.koko();
+	if (p > 0 && koko > FEC_MAX_DATA_SIZE)
+		koko = FEC_MAX_DATA_SIZE;
+	return koko;
+}
+
+int ryhmanK(int pala)
+{
+	// Ryhmän data ei saa ylittää vastaanottimen ikkunaa. Nollaikkunassa
+	// lähetetään yksi paketti, jonka kuittaus kertoo ikkunan uudelleen.
+	int k = fec.k();
+	int mahtuu = vastaanottajan_ikkuna / pala;
+	if (mahtuu < 1)
+		mahtuu = 1;
+	return k < mahtuu ? k : mahtuu;
+}
+
+bool kasaaRyhma(Lahetysryhma * r, uint32_t ptr, uint8_t numero)
+{
+	// Kasataan enintään K peräkkäistä palaa ryhmäksi
+	jpeg_paloittelu.merkitse(ptr);
+	r->pyydetty_koko = palan_koko.koko();
+	r->pyydetty_p = fec.p();
+	int koko = ryhmanPala(r->pyydetty_p);
+	r->pyydetty_k = ryhmanK(koko);
+
+	int k = 0;
+	do {
+		if (kasaaPaketti(r->kehys[k], ptr, koko, numero + k) < 0) {
+			r->kasattu = false;
+			return false;
+		}
+		ptr += (uint8_t)r->kehys[k][1];
+		k++;
+	} while (k < r->pyydetty_k && ptr < lahetettava_koko);
+
+	for (int i = 0; i < k; i++)
+		r->kehys[i][5] = (int8_t)((i << 4) | (k - 1));
+	r->k = k;
+	r->loppu = ptr;
+
+	// Pariteetit kasataan samalla, pariteetteja ei kannata olla enempää
+	// kuin ryhmässä on paketteja
+	r->p = r->pyydetty_p < k ? r->pyydetty_p : k;
+	for (int j = 0; j < r->p; j++)
+		kasaaPariteetti(r->kehys[k + j], r->kehys, k, r->p, j);
+	r->kasattu = true;
+	return true;
+}
+
+bool ryhmaAjantasalla(Lahetysryhma * r)
+{
+	return r->kasattu && r->pyydetty_koko == palan_koko.koko() &&
+		r->pyydetty_p == fec.p() && r->pyydetty_k == ryhmanK(ryhmanPala(fec.p()));
+}
+
+Kehys* varaaKehys(uint8_t osoite)
+{
+	// Odotetaan vapaata paikkaa jonossa, jos radio ei ehdi lähettää
+	Kehys* kehys;
+	while(!(kehys = kehysjono1.varaa()))
 	{
-		if ( ptr > (int)sizeof(table)) {
-			message[HEADER_SIZE+i] = 0x00;
-			// Viimeinenkin lähetetty paketti on 50 byteä,
-			// tässä laitetaan ylimääräiset nollaksi.
-			// ( ptr > table-taulukon alkioiden määrä)
+		ThisThread::sleep_for(1);
+	}
+	kehys->osoite = osoite;
+	return kehys;
+}
+
+Kehys* jonoon(uint8_t osoite, const int8_t* paketti, int koko)
+{
+	// Kopioidaan valmis paketti jonoon, radiothread lähettää sen
+	Kehys* kehys = varaaKehys(osoite);
+	memcpy(kehys->data, paketti, koko);
+	kehys->koko = koko;
+	return kehys;
+}
+
+void lahetaKehys(const int8_t* paketti, int koko, bool kysy)
+{
+	// Kuittauspyyntö on vain lähetyksen viimeisessä paketissa, tallessa
+	// olevassa paketissa lippu on aina pois (pariteetit lasketaan niistä)
+	Kehys* kehys = jonoon(transmitter_target_receiver_address, paketti, koko);
+	if (kysy)
+		kehys->data[0] |= HEADER_ACK_REQUEST_FLAG;
+	kehysjono1.julkaise();
+	lahetyksen_bitit += KuittausAika::bitteja(koko);
+}
+
+void lahetaRyhma(bool pariteetit)
+{
+	// Ryhmästä lähetetään ne paketit, joita vastaanotin ei ole kuitannut
+	// (ensimmäisellä kerralla kaikki ja pariteetit)
+	int k = ryhma1->k;
+	int p = pariteetit ? ryhma1->p : 0;
+	int lahetettyja = 0;
+	int tavuja = 0;
+
+	int viimeinen = -1;
+	ryhman_lahetetyt = 0;
+	for (int i = 0; i < k; i++)
+		if (!(ryhman_saadut & (1 << i))) {
+			viimeinen = i;
+			ryhman_lahetetyt |= (uint16_t)(1 << i);
+		}
+
+	for (int i = 0; i < k + p; i++) {
+		if (i < k && (ryhman_saadut & (1 << i)))
+			continue;
+		int paketin_koko = HEADER_SIZE + (uint8_t)ryhma1->kehys[i][1];
+		lahetaKehys(ryhma1->kehys[i], paketin_koko, p == 0 ? i == viimeinen : i == k + p - 1);
+		if (i < k)
+			lahetettyja++;
+		tavuja += paketin_koko;
+	}
+
+	jaljita(J1_RYHMA_LAHETETTY, lahetettyja, k, p, tavuja); // helpottamaan seuraamista
+}
+
+void kirjaaKatoaminen(int saatuja, int kadonneita)
+{
+	// Arvio päivitetään ensin, molemmat säätimet lukevat saman osuuden
+	pakettien_katoaminen.paketit(saatuja, kadonneita);
+	palan_koko.paketit(saatuja, kadonneita);
+	fec.paivita();
+}
+
+void kirjaaPaketit(uint16_t saadut)
+{
+	// Säätimet saavat katoamisen paketeittain kuittauksen bittikartasta:
+	// jokainen lähetetty datapaketti on joko saatu tai kadonnut
+	int saatuja = 0;
+	int kadonneita = 0;
+	for (int i = 0; i < FEC_MAX_K; i++) {
+		if (!(ryhman_lahetetyt & (1 << i)))
+			continue;
+		if (saadut & (1 << i))
+			saatuja++;
+		else
+			kadonneita++;
+	}
+	kirjaaKatoaminen(saatuja, kadonneita);
+}
+
+const uint8_t* lueVastaus(int koko)
+{
+	// Vastaanottimelta tulee erillisiä kuittauksia ja tilapaketteja,
+	// joiden perässä voi olla kuittaus (protokolla.h)
+	const uint8_t* paketti = (const uint8_t *)buffer1;
+	const uint8_t* kuittaus = kuittausPaketissa(paketti, koko);
+	if (kuittaus != paketti && koko >= HEADER_SIZE + TILA_DATA_SIZE &&
+		(paketti[0] & HEADER_INFO_FLAG) && paketti[1] == TILA_DATA_SIZE)
+	{
+		jaljita(paketti[HEADER_SIZE] ? J1_VASTAANOTIN_KUNNOSSA : J1_VASTAANOTIN_VIRHEELLINEN,
+			lueU32(&paketti[HEADER_SIZE + 1]), kuittaus ? 1 : 0);
+	}
+	else if (!kuittaus)
+	{
+		jaljita(J1_TUNTEMATON_KUITTAUS, koko);
+	}
+	return kuittaus;
+}
+
+Kuittaus odotaKuittausta(int threshold1)
+{
+	// Odotetaan tähän lähetykseen kuuluvaa kuittausta (protokolla.h)
+	// enintään threshold1 ms lähetyksen alusta. Myöhästyneet ja kahdentuneet
+	// kuittaukset tunnistetaan järjestysnumerosta ja ohitetaan.
+	while(kuittauskello1.read_ms()<threshold1)
+	{
+		int koko = vastaanotin1.recv(&buffer1,BUFFER_SIZE);
+		if (koko == 0) {
+			// Odotusaikana kasataan seuraava ryhmä valmiiksi
+			if (tiedot_kuitattu && !seuraava1->kasattu && !seuraava_epaonnistui && ryhma1->loppu < lahetettava_koko)
+				seuraava_epaonnistui = !kasaaRyhma(seuraava1, ryhma1->loppu, seq + ryhma1->k);
+			continue;
+		}
+		const uint8_t* ack = lueVastaus(koko);
+		if (!ack)
+			continue;
+
+		bool tietopaketin = ack[0] & ACK_INFO_FLAG;
+		uint8_t kuitattu = ack[1];
+		uint16_t saadut = lueU16(&ack[2]);
+		uint16_t ikkuna = lueU16(&ack[4]);
+		int8_t ero = (int8_t)(kuitattu - seq);
+		jaljita(J1_KUITTAUS, kuitattu, saadut, ikkuna);
+
+		if (!tiedot_kuitattu) {
+			if (tietopaketin && ero == 0) {
+				vastaanottajan_ikkuna = ikkuna;
+				return KUITATTU;
 			}
-		else {
-			message[HEADER_SIZE+i] = table[ptr++];
+			continue;
 		}
+		if (tietopaketin || ero < 0)
+			continue;
+		vastaanottajan_ikkuna = ikkuna;
+		if (ero >= ryhma1->k)
+			return KUITATTU;
+
+		// Ryhmä on kesken: kuittausnumeroa edeltävät ja bittikartan
+		// paketit on saatu, muut lähetetään uudelleen
+		ryhman_saadut |= (uint16_t)((saadut << ero) | ((1 << ero) - 1));
+		return PUUTTUU;
 	}
+	return EI_KUITTAUSTA;
+}
 
-	// Paketin toinen byte on datapaketin koko
-	message[1] = ptr - paketti_startptr;
+void odotaIkkunaa()
+{
+	// Vastaanotin on sulkenut ikkunan (esimerkiksi tulostaa valmista
+	// kuvaa), joten odotetaan ikkunapäivitystä eli kuittausta, jonka
+	// järjestysnumero on seuraavaksi lähetettävän ryhmän. Jos sitä ei
+	// tule, lähetetään yksi paketti kokeiluna (ryhmanK).
+	Timer odotus;
+	odotus.start();
+	while(vastaanottajan_ikkuna == 0 && odotus.read_ms() < IKKUNA_ODOTUS)
+	{
+		int koko = vastaanotin1.recv(&buffer1,BUFFER_SIZE);
+		if (koko == 0) {
+			ThisThread::sleep_for(1);
+			continue;
+		}
+		const uint8_t* ack = lueVastaus(koko);
+		if (ack && ack[0] == ACK_TUNNISTE && ack[1] == seq)
+			vastaanottajan_ikkuna = lueU16(&ack[4]);
+	}
+	jaljita(J1_VASTAANOTTAJAN_IKKUNA, vastaanottajan_ikkuna);
+}
 
-	// Jos ptr > table-taulun (pakattu_kuva.h) alkioiden määrä
-	// laitetaan lippu merkiksi viimeisestä paketista
-	if ( ptr > (int)sizeof(table) ) {
-		message[0] += (1 << 6);
+
+void yleislahetys()
+{
+	// Symboleita lähetetään jatkuvasti, jokainen vastaanotin purkaa kuvan
+	// saatuaan niitä tarpeeksi. Sama data saa aina saman siirron
+	// tunnisteen, joten myöhemmin aloittanut tai paljon paketteja
+	// menettänyt vastaanotin jatkaa keräämistä seuraavilla symboleilla.
+	int symbolin_koko = LT_MAX_SYMBOLIN_KOKO;
+	int k = ltSymboleita(lahetettava_koko, symbolin_koko);
+	if (k > LT_MAX_K) {
+		jaljita(J1_EI_MAHDU_YLEISLAHETYKSEEN, k);
+		return;
+	}
+	uint8_t siirto = (uint8_t)lahteenCrc32(lahetettava);
+	jaljita(J1_YLEISLAHETYS, k, symbolin_koko);
+
+	for (uint16_t esn = 0; ; esn++)
+	{
+		int paketin_koko;
+		if (esn % YLEISLAHETYS_TIETOVALI == 0)
+		{
+			paketin_koko = kasaaTietopaketti();
+			message[0] |= HEADER_FOUNTAIN_FLAG;
+			message[4] = siirto;
+			message[5] = k - 1;
+			jonoon(ASK_TRANSMITTER_BROADCAST_ADDRESS, message, paketin_koko);
+			kehysjono1.julkaise();
+		}
+
+		// Symboli koodataan suoraan jonon paikkaan
+		Kehys* kehys = varaaKehys(ASK_TRANSMITTER_BROADCAST_ADDRESS);
+		kehys->data[0] = HEADER_FOUNTAIN_FLAG;
+		kehys->data[1] = symbolin_koko;
+		kirjoitaU16(&kehys->data[2], esn);
+		kehys->data[4] = siirto;
+		kehys->data[5] = k - 1;
+		int symboli = ltKoodaa(&kehys->data[HEADER_SIZE], lahetettava, symbolin_koko, esn);
+		if (symboli < 0) {
+			jaljita(J1_LUKUVIRHE);
+			return;
+		}
+		kehys->koko = HEADER_SIZE + symboli;
+		kehysjono1.julkaise();
+		jaljita(J1_SYMBOLI_LAHETETTY, esn); // helpottamaan seuraamista
+	}
+}
+
+
+uint64_t keraaNackit(uint8_t siirto, int k, unsigned int* nackeja)
+{
+	// Kun radio on lähettänyt kierroksen, kuunnellaan NACKeja
+	// korjausikkunan ajan. Ikkunaan mahtuvat radion puskurissa vielä
+	// oleva paketti, vastaanottimien satunnainen odotus ja NACK. Kaikkien
+	// vastaanottimien pyytämät palat yhdistetään.
+	while (kehysjono1.syvyys() > 0)
+		ThisThread::sleep_for(1);
+	int ikkuna = kuittausaika.ilmaaika(KuittausAika::bitteja(MAX_MESSAGE_SIZE) + KuittausAika::bitteja(NACK_KOKO(NACK_MAX_ALUEITA))) +
+		MONI_NACK_VIIVE + MONI_KASITTELYAIKA;
+
+	uint64_t pyydetyt = 0;
+	Timer odotus;
+	odotus.start();
+	while (odotus.read_ms() < ikkuna)
+	{
+		int koko = vastaanotin1.recv(&transmitter_received_receiver_address, &transmitter_received_transmitter_address, &buffer1, BUFFER_SIZE);
+		if (koko == 0) {
+			ThisThread::sleep_for(1);
+			continue;
+		}
+		if (transmitter_received_receiver_address != RYHMAOSOITE || !onNack((const uint8_t *)buffer1, koko))
+			continue;
+		pyydetyt |= lueNack((const uint8_t *)buffer1, koko, siirto) & moniKaikki(k);
+		(*nackeja)++;
 	}
+	return pyydetyt;
+}
 
+void monilahetys()
+{
+	// Palat lähetetään ryhmäosoitteeseen ja kierroksen lopuksi
+	// tietopaketti. Seuraavalla kierroksella lähetetään kerran ne palat,
+	// joita joku vastaanotin pyysi, kunnes NACKeja ei enää tule.
+	uint8_t siirto = (uint8_t)lahteenCrc32(lahetettava);
+	while (true)
+	{
+		int k = moniPaloja(lahetettava_koko);
+		if (k > MONI_MAX_PALOJA) {
+			jaljita(J1_EI_MAHDU_MONILAHETYKSEEN, k);
+			return;
+		}
+		jaljita(J1_MONILAHETYS, siirto, k);
+
+		uint64_t lahetettavat = moniKaikki(k);
+		int kierros = 0;
+		int hiljaisia = 0;
+		unsigned int paloja = 0;
+		unsigned int nackeja = 0;
+		while (hiljaisia < MONI_HILJAISIA)
+		{
+			for (int i = 0; i < k; i++)
+			{
+				if (!((lahetettavat >> i) & 1))
+					continue;
+				// Pala luetaan suoraan jonon paikkaan
+				Kehys* kehys = varaaKehys(RYHMAOSOITE);
+				int koko = lahetettava->lue((uint32_t)i * MONI_PALAN_KOKO, (uint8_t *)&kehys->data[HEADER_SIZE], MONI_PALAN_KOKO);
+				if (koko < 0) {
+					jaljita(J1_LUKUVIRHE);
+					return;
+				}
+				kehys->data[0] = 0;
+				kehys->data[1] = koko;
+				kirjoitaU16(&kehys->data[2], (uint16_t)i);
+				kehys->data[4] = siirto;
+				kehys->data[5] = k - 1;
+				kehys->koko = HEADER_SIZE + koko;
+				kehysjono1.julkaise();
+				paloja++;
+			}
+
+			// Tietopaketti kertoo, että kierros on lähetetty
+			int paketin_koko = kasaaTietopaketti();
+			kirjoitaU16(&message[2], (uint16_t)kierros);
+			message[4] = siirto;
+			message[5] = k - 1;
+			jonoon(RYHMAOSOITE, message, paketin_koko);
+			kehysjono1.julkaise();
+
+			lahetettavat = keraaNackit(siirto, k, &nackeja);
+			jaljita(J1_KIERROS_LAHETETTY, kierros, moniMaara(lahetettavat)); // helpottamaan seuraamista
+			hiljaisia = lahetettavat ? 0 : hiljaisia + 1;
+			kierros++;
+		}
+
+		jaljita(J1_MONILAHETYS_VALMIS, kierros, paloja, k, nackeja);
+		wait_us(10000*1000);
+		pakkaaKuva();
+		siirto++;
+	}
 }
 
 
 /*********************************************************************
-* Eka thread eli lähetin joka lähettää paketteja
+* Radiothread, joka lähettää ekan threadin jonoon kasaamat paketit
 *********************************************************************/
-void ekaThreadFunction()
+void radioThreadFunction()
 {
-	while(!lahetin1.init(1000,D7,transmitter_address))
+	while(!lahetin1.init(BITTINOPEUS,D7,transmitter_address))
 	{
-		pc.printf("1: trasmitter1 initialization failed\r\n");
+		jaljita(J1_LAHETIN_ALUSTUS_EPAONNISTUI);
 	}
-	pc.printf("1: lahettimen lahetin1 alustettu\r\n");
-	
-    while(!vastaanotin1.init(1000,D5,transmitter_receiver_address))
+	jaljita(J1_LAHETIN_ALUSTETTU);
+
+	while(true)
 	{
-		pc.printf("1: receiver1 initialization failed\r\n");
+		Kehys* kehys = kehysjono1.seuraava();
+		if (!kehys)
+		{
+			ThisThread::sleep_for(1);
+			continue;
+		}
+		while(!lahetin1.send(kehys->osoite,kehys->data, kehys->koko))
+		{
+			jaljita(J1_LAHETYS_EPAONNISTUI);
+		}
+		kehysjono1.vapauta();
 	}
-	pc.printf("1: lahettimen vastaanotin1 alustettu\r\n");
+}
 
-	// Tulostetaan viestin koko sarjaportille
-	pc.printf("1: viestin koko=%i B\n\r", viestin_koko);
+
+void uusiSiirto()
+{
+	// Seuraava siirto alkaa tietopaketista, kuva luetaan ja pakataan
+	// uudelleen
+	offset = 0;
+	tiedot_kuitattu = false;
+	ryhma1->kasattu = seuraava1->kasattu = false;
+	seuraava_epaonnistui = false;
+	wait_us(10000*1000);
+	pakkaaKuva();
+}
+
+
+/*********************************************************************
+* Eka thread eli lähetin joka kasaa paketit ja käsittelee kuittaukset
+*********************************************************************/
+void ekaThreadFunction()
+{
+    while(!vastaanotin1.init(BITTINOPEUS,D5,transmitter_receiver_address))
+	{
+		jaljita(J1_VASTAANOTIN_ALUSTUS_EPAONNISTUI);
+	}
+	jaljita(J1_VASTAANOTIN_ALUSTETTU);
+	// Monilähetyksen NACKit tulevat ryhmäosoitteeseen
+	vastaanotin1.rx_group_address = RYHMAOSOITE;
 
 	// Lähetettyjen 
 	int pakettien_maara = 0;
+
+	// Kuva pakataan ennen jokaista siirtoa
+	pakkaaKuva();
+
+	// Tulostetaan viestin koko sarjaportille
+	jaljita(J1_VIESTIN_KOKO, viestin_koko);
+
+	// Yleislähetyksestä palataan vain, jos kuva ei mahdu siihen
+	if (YLEISLAHETYS)
+		yleislahetys();
+
+	// Monilähetyksestä palataan vain, jos kuva ei mahdu siihen
+	if (MONILAHETYS)
+		monilahetys();
 	    
     while(true)
 	{
-        
-		kasaaPaketti(offset);
-		int paketin_koko = sizeof(message); // Lähetettävän paketin koko (byteä)
-					
-		while(!lahetin1.send(transmitter_target_receiver_address,&message, sizeof(message)))
+		// Kiertoaika mitataan lähetyksen alusta, joten kuittauskello
+		// käynnistetään ennen ensimmäistä pakettia
+		kuittauskello1.reset();
+		kuittauskello1.start();
+		lahetyksen_bitit = KuittausAika::bitteja(ACK_SIZE);
+		bool ensimmainen = true;	// kiertoaika mitataan vain ensimmäisestä lähetyksestä
+
+		// Uutta dataa ei lähetetä suljettuun ikkunaan, uudelleenlähetykset
+		// mahtuvat jo aiemmin kerrottuun ikkunaan
+		if (vastaanottajan_ikkuna == 0 && (tiedot_kuitattu ? !ryhma_lahetetty : !tietopaketti_uudelleen))
 		{
-			pc.printf("1: trasmitter sending failed\r\n");
+			odotaIkkunaa();
+			kuittauskello1.reset();
 		}
 
-		pc.printf("1: Lahetetty paketti %i B\n\r", paketin_koko); // helpottamaan seuraamista
-		
-		kuittauskello1.reset();
-		kuittauskello1.start();
-		int threshold1 = 5;
-		int koko = 0;
-		while(koko == 0&&kuittauskello1.read()<threshold1)
+		// Ennen kuvan ensimmäistä pakettia lähetetään tietopaketti,
+		// sen jälkeen data lähetetään ryhminä (fec.h)
+		if (!tiedot_kuitattu)
 		{
-			koko = vastaanotin1.recv(&buffer1,BUFFER_SIZE);
+			int paketin_koko = kasaaTietopaketti(); // Lähetettävän paketin koko (byteä)
+			lahetaKehys(message, paketin_koko, false);
+			ensimmainen = !tietopaketti_uudelleen;
+			jaljita(J1_TIETOPAKETTI_LAHETETTY, paketin_koko); // helpottamaan seuraamista
 		}
+		else
+		{
+			// Kuittaamattomasta ryhmästä lähetetään uudelleen vain puuttuvat paketit.
+			// Uusi ryhmä on yleensä jo kasattu edellisen kuittausta odotettaessa.
+			if (!ryhma_lahetetty)
+			{
+				if (!ryhmaAjantasalla(ryhma1) && !kasaaRyhma(ryhma1, offset, seq))
+				{
+					// Kuvaa ei saada luettua, joten siirtoa ei voi jatkaa
+					jaljita(J1_SIIRTO_KESKEYTETTY, offset, lahetettava_koko);
+					pakettien_maara = 0;
+					uusiSiirto();
+					continue;
+				}
+				ryhma_lahetetty = true;
+				ryhman_saadut = 0;
+				ryhma_uudelleen = false;
+			}
+			ensimmainen = !ryhma_uudelleen;
+			lahetaRyhma(!ryhma_uudelleen);
+		}
+		
+		int rto = kuittausaika.rto(lahetyksen_bitit);
+		Kuittaus kuittaus = odotaKuittausta(rto);
+		if (kuittaus != EI_KUITTAUSTA && ensimmainen)
+			kuittausaika.mittaus(kuittauskello1.read_ms(), lahetyksen_bitit);
 		
-		if(koko == 0)  // tarkoittaa, että kuittauskello laukesi
+		if(kuittaus == EI_KUITTAUSTA)  // tarkoittaa, että kuittauskello laukesi
 		{
 			//char msg[] = "kuittauskello laukesi";
 			//printMsg(msg);
 						
 						
-		    string msg("1: kuittauskello laukesi");
-			printMsg(msg);
-
-			
-			
+		    jaljita(J1_KUITTAUSKELLO_LAUKESI);
+			jaljita(J1_ODOTUSAIKA, rto);
+			kuittausaika.laukesi();
+			if (!tiedot_kuitattu)
+				tietopaketti_uudelleen = true;
+			else
+			{
+				// Ilman kuittausta ei tiedetä, mitkä paketit katosivat,
+				// joten säätimille se on yksi katoaminen
+				kirjaaKatoaminen(0, 1);
+				ryhma_uudelleen = true;
+			}
+		}
+		else if(kuittaus == PUUTTUU)   // vastaanotin kertoi, mitkä paketit puuttuvat
+		{
+			jaljita(J1_RYHMASTA_PUUTTUU);
+			kirjaaPaketit(ryhman_saadut);
+			ryhma_uudelleen = true;
 		}
         else           // saatiin kuittaus vastaanottajalta
 	    {
-			string msg("1: kuittaus vastaanotettu");
-			pakettien_maara++;
-			printMsg(msg);
-            offset = offset + PACKET_DATA_SIZE;
-			if(offset > (sizeof(table)))
+			jaljita(J1_KUITTAUS_VASTAANOTETTU);
+			if (!tiedot_kuitattu)
+			{
+				tiedot_kuitattu = true;
+				tietopaketti_uudelleen = false;
+				pakettien_maara++;
+			}
+			else
+			{
+				// Kaikki viimeksi lähetetyt paketit saatiin
+				kirjaaPaketit(ryhman_lahetetyt);
+				offset = ryhma1->loppu;
+				seq += ryhma1->k;
+				pakettien_maara += ryhma1->k;
+
+				// Vaihdetaan valmiiksi kasattu ryhmä lähetettäväksi
+				Lahetysryhma * lahetetty = ryhma1;
+				ryhma1 = seuraava1;
+				seuraava1 = lahetetty;
+				seuraava1->kasattu = false;
+				seuraava_epaonnistui = false;
+				ryhma_lahetetty = false;
+			}
+			if(offset >= lahetettava_koko)
 		    {	
-				// kun offset > table-taulun alkioiden määrä, eli
-				// viimeinen paketti on kasattu,
+				// kun offset >= lähetettävän datan koko, eli
+				// viimeinen paketti on kuitattu,
 				// tulostetaan sarjaportille tieto helpottamaan seuraamista
 
-				pc.printf("1: __________Offset reset, lahetettyja paketteja %i ________\n\r", pakettien_maara);
-				offset = pakettien_maara = 0;
-				wait_us(10000*1000);
+				jaljita(J1_SIIRTO_VALMIS, pakettien_maara, palan_koko.koko(), fec.k(), fec.p(), kuittausaika.rto(lahetyksen_bitit));
+				jaljita(J1_JONO, kehysjono1.suurinSyvyys(), KEHYSJONO_PAIKKOJA, kehysjono1.tyhjenemisia(), kehysjono1.taynna());
+				kehysjono1.nollaaMittarit();
+				pakettien_maara = 0;
+				uusiSiirto();
 		    }
-
-			// Tämä tulostaa vastaanottimen takaisin lähettämän kuittausviestin
-			// sarjaportille
-			pc.printf("1: vastaanotettu: ");
-			//printData(string((char *)&buffer1,koko));  // this prints data as integers
-			printMsg(string((char *)&buffer1,koko));    // and this prints it as characters
 		}
 	}
 }
-
-
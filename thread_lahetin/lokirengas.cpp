@@ -0,0 +1,70 @@
+#include "lokirengas.h"
+#include <string.h>
+
+LokiRengas::LokiRengas()
+{
+	// Paikka i on vapaa kirjoituskohdalle i
+	for (uint32_t i = 0; i < LOKI_PAIKKOJA; i++)
+		_paikat[i].jarjestys = i;
+	_kirjoitus = 0;
+	_luku = 0;
+	_pudotettuja = 0;
+}
+
+bool LokiRengas::kirjoita(Tyyppi tyyppi, const void* data, int koko)
+{
+	uint32_t kohta = _kirjoitus;
+	Paikka* paikka;
+	for (;;) {
+		paikka = &_paikat[kohta & (LOKI_PAIKKOJA - 1)];
+		int32_t ero = (int32_t)(paikka->jarjestys - kohta);
+		if (ero == 0) {
+			// Paikka on vapaa, varataan se, ellei toinen tuottaja ehtinyt
+			// ensin (silloin kohta päivittyy nykyiseen kirjoituskohtaan)
+			if (core_util_atomic_cas_u32(&_kirjoitus, &kohta, kohta + 1))
+				break;
+		}
+		else if (ero < 0) {
+			// Kuluttaja ei ole vielä vapauttanut paikkaa edelliseltä kierrokselta
+			core_util_atomic_incr_u32(&_pudotettuja, 1);
+			return false;
+		}
+		else {
+			kohta = _kirjoitus;
+		}
+	}
+
+	if (koko > LOKI_TIETUEEN_KOKO)
+		koko = LOKI_TIETUEEN_KOKO;
+	paikka->tietue.tyyppi = (uint8_t)tyyppi;
+	paikka->tietue.koko = (uint8_t)koko;
+	memcpy(paikka->tietue.data, data, koko);
+
+	// Tietue on kirjoitettu ennen kuin kuluttaja näkee sen
+	__DMB();
+	paikka->jarjestys = kohta + 1;
+	return true;
+}
+
+const LokiTietue* LokiRengas::seuraava()
+{
+	Paikka* paikka = &_paikat[_luku & (LOKI_PAIKKOJA - 1)];
+	if (paikka->jarjestys != _luku + 1)
+		return 0;
+	__DMB();
+	return &paikka->tietue;
+}
+
+void LokiRengas::vapauta()
+{
+	// Tietue on luettu ennen kuin tuottaja voi kirjoittaa paikkaan
+	Paikka* paikka = &_paikat[_luku & (LOKI_PAIKKOJA - 1)];
+	__DMB();
+	paikka->jarjestys = _luku + LOKI_PAIKKOJA;
+	_luku++;
+}
+
+uint32_t LokiRengas::pudotettuja()
+{
+	return _pudotettuja;
+}
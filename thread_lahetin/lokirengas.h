@@ -0,0 +1,70 @@
+/*
+* Lukoton lokirengas usealta tuottajalta yhdelle kuluttajalle (MPSC)
+*
+* Lähettimen ja vastaanottimen threadit kirjoittavat viestit ja datan
+* renkaan valmiiksi varattuihin tietueisiin, ja EventThread tyhjentää
+* renkaan sarjaportille erissä (main.cpp). Kirjoittaminen ei varaa
+* muistia eikä odota: jos rengas on täynnä, tietue pudotetaan ja
+* lasketaan.
+*
+* Jokaisella paikalla on järjestysnumero (Vyukovin rajattu jono):
+* tuottaja varaa kirjoituskohdan vertaa-ja-vaihda -operaatiolla, kun
+* paikan numero kertoo sen olevan vapaa, ja julkaisee tietueen
+* kasvattamalla numeroa. Kuluttaja lukee paikan, kun numero kertoo sen
+* olevan julkaistu, ja vapauttaa sen seuraavaa kierrosta varten.
+*/
+
+#ifndef LOKIRENGAS_H
+#define LOKIRENGAS_H
+
+#include "mbed.h"
+#include <stdint.h>
+
+#define LOKI_PAIKKOJA 16			// 2:n potenssi
+#define LOKI_TIETUEEN_KOKO 64		// pidemmät viestit ja data katkaistaan
+
+#if (LOKI_PAIKKOJA & (LOKI_PAIKKOJA - 1))
+#error LOKI_PAIKKOJA pitää olla 2:n potenssi
+#endif
+
+struct LokiTietue
+{
+	uint8_t tyyppi;					// LokiRengas::Tyyppi
+	uint8_t koko;
+	uint8_t data[LOKI_TIETUEEN_KOKO];
+};
+
+class LokiRengas
+{
+public:
+	enum Tyyppi { VIESTI = 0, DATA = 1, JALJITYS = 2 };	// JALJITYS: 32-bittiset sanat (jaljitys.h)
+
+	LokiRengas();
+
+	// Tuottaja (mikä tahansa thread): kopioidaan tietue renkaaseen,
+	// palauttaa false, jos rengas on täynnä ja tietue pudotettiin
+	bool kirjoita(Tyyppi tyyppi, const void* data, int koko);
+
+	// Kuluttaja: seuraava julkaistu tietue tai 0, jos rengas on tyhjä
+	const LokiTietue* seuraava();
+
+	// Kuluttaja: tietue on käsitelty, paikka vapautuu
+	void vapauta();
+
+	// Täyden renkaan takia pudotetut tietueet
+	uint32_t pudotettuja();
+
+private:
+	struct Paikka
+	{
+		volatile uint32_t jarjestys;
+		LokiTietue tietue;
+	};
+
+	Paikka _paikat[LOKI_PAIKKOJA];
+	volatile uint32_t _kirjoitus;	// tuottajien yhteinen, kasvatetaan vertaa-ja-vaihda -operaatiolla
+	uint32_t _luku;					// vain kuluttaja
+	volatile uint32_t _pudotettuja;
+};
+
+#endif
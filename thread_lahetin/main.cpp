@@ -1,22 +1,72 @@
 #include "mbed.h"
-#include <string>
+#include <string.h>
+#include "lokirengas.h"
+#include "jaljitys.h"
+#include "sarjakehys.h"
+#include "sarjapuskuri.h"
+#include "monitori.h"
+#include "ask_transmitter.h"
+#include "ask_receiver.h"
 
 EventQueue queue;
-void handler(string printattavaViesti,int msgType);
-Event<void(string,int)> event(&queue, handler);	
+
+// Viestit, data ja jäljitystietueet kulkevat lokirenkaan kautta
+// (lokirengas.h), EventThread tyhjentää sen sarjaportille LOKI_VALI ms
+// välein enintään LOKI_ERA merkin erissä
+#define LOKI_VALI 10
+#define LOKI_ERA 512
+LokiRengas loki;
+char loki_era[LOKI_ERA];
+uint32_t loki_pudotettuja = 0;		// viimeksi tulostettu pudotettujen määrä
+
+// Jäljitystietueet: 1 = binäärisinä kehyksinä, jotka host/sarjadekooderi.cpp
+// muotoilee, 0 = EventThread muotoilee rivit itse (jaljitys.h)
+#define JALJITYS_BINAARI 1
+#define JALJITYS_RIVI 128
+
+// Vastaanotettu kuva: 1 = binäärisenä COBS-kehyksenä, jonka
+// host/sarjadekooderi.cpp kirjoittaa tiedostoksi, 0 = bytet tekstinä ("%i ")
+#define BINAARITULOSTE 1
+Semaphore kuva_tulostettu(0);
 
 void EventThreadFunction(void);
-void printMsg(string msg);
-void printData(string data);
+void tyhjennaLoki();
+void printMsg(const char* msg);
+void printData(const void* data, int koko);
+void printImage(const void* kuva, uint32_t pituus, bool kunnossa);
 extern void tokaThreadFunction();
 extern void ekaThreadFunction();
+extern void radioThreadFunction();
 
 
 DigitalOut myled(LED1);
-Serial pc(USBTX, USBRX);
+RawSerial pc(USBTX, USBRX);
+SarjaPuskuri sarja(&pc);		// kaikki tulostus, UARTin keskeytys lähettää (sarjapuskuri.h)
+
+// Threadien pinot ovat täällä, jotta monitori voi maalata ne ennen
+// käynnistystä ja mitata suurimman käytön (monitori.h). Koko on sama
+// kuin mbedin oletus.
+#define PINON_KOKO 4096
+MBED_ALIGN(8) unsigned char eka_pino[PINON_KOKO];
+MBED_ALIGN(8) unsigned char toka_pino[PINON_KOKO];
+MBED_ALIGN(8) unsigned char radio_pino[PINON_KOKO];
+MBED_ALIGN(8) unsigned char event_pino[PINON_KOKO];
+
+Thread ekaLahetin(osPriorityNormal, PINON_KOKO, eka_pino);
+Thread tokaLahetin(osPriorityNormal, PINON_KOKO, toka_pino);
+Thread radioLahetin(osPriorityNormal, PINON_KOKO, radio_pino);
+Thread EventThread(osPriorityAboveNormal, PINON_KOKO, event_pino);
 
-Thread ekaLahetin(osPriorityNormal);
-Thread tokaLahetin(osPriorityNormal);
+// Threadien prosessoriaika, pinot ja radion keskeytykset raportoidaan
+// MONITORI_VALI ms välein
+#define MONITORI_VALI 5000
+Monitori monitori;
+extern ask_transmitter_t lahetin1;
+extern ask_transmitter_t lahetin2;
+extern ask_receiver_t vastaanotin1;
+extern ask_receiver_t vastaanotin2;
+void lahettimienKeskeytykset(uint32_t* kertoja, uint32_t* jaksoja);
+void vastaanottimienKeskeytykset(uint32_t* kertoja, uint32_t* jaksoja);
 
 char testiviesti[] = "pelaa";
 int8_t buffer[3] = {-1,3,2};
@@ -24,45 +74,179 @@ int8_t * ptr = &buffer[0];
 
 int main()
 {
-	pc.printf("________________RESET____________________\n\r");
-	Thread EventThread(osPriorityAboveNormal);
+	const char reset[] = "________________RESET____________________\n\r";
+	sarja.kirjoita(reset, sizeof(reset) - 1);
+	monitori.lisaa(&ekaLahetin, J0_EKA_LAHETIN, eka_pino, sizeof(eka_pino));
+	monitori.lisaa(&tokaLahetin, J0_TOKA_LAHETIN, toka_pino, sizeof(toka_pino));
+	monitori.lisaa(&radioLahetin, J0_RADIO_LAHETIN, radio_pino, sizeof(radio_pino));
+	monitori.lisaa(&EventThread, J0_EVENT_THREAD, event_pino, sizeof(event_pino));
+	monitori.lisaa(0, J0_MAIN, 0, 0);
+	monitori.lisaaKeskeytys(J0_ASK_LAHETTIMET, lahettimienKeskeytykset);
+	monitori.lisaaKeskeytys(J0_ASK_VASTAANOTTIMET, vastaanottimienKeskeytykset);
 	EventThread.start(EventThreadFunction);
     ekaLahetin.start(ekaThreadFunction);
+    radioLahetin.start(radioThreadFunction);
     tokaLahetin.start(tokaThreadFunction);
+	monitori.aloita();
+
+	// main ei pyöri tyhjässä silmukassa muiden threadien kanssa, vaan
+	// nukkuu raporttien välillä
     while(1)
     {
-
+		ThisThread::sleep_for(MONITORI_VALI);
+		monitori.raportoi(J0_MUUT);
+		jaljita(J0_SARJAPUSKURI, sarja.suurinKaytto(), SARJAPUSKURI_KOKO, sarja.taynna());
     }
 
 }
 
+void lahettimienKeskeytykset(uint32_t* kertoja, uint32_t* jaksoja)
+{
+	ask_transmitter_status_t tila;
+	lahetin1.status(&tila);
+	*kertoja = tila.interrupts;
+	*jaksoja = tila.interrupt_cycles;
+	lahetin2.status(&tila);
+	*kertoja += tila.interrupts;
+	*jaksoja += tila.interrupt_cycles;
+}
+
+void vastaanottimienKeskeytykset(uint32_t* kertoja, uint32_t* jaksoja)
+{
+	ask_receiver_status_t tila;
+	vastaanotin1.status(&tila);
+	*kertoja = tila.interrupts;
+	*jaksoja = tila.interrupt_cycles;
+	vastaanotin2.status(&tila);
+	*kertoja += tila.interrupts;
+	*jaksoja += tila.interrupt_cycles;
+}
+
 void EventThreadFunction(void)
 {
+	queue.call_every(LOKI_VALI, tyhjennaLoki);
     queue.dispatch_forever();
 }
 
-void handler(string viesti,int type) {
+void kirjoitaEra(int* kohta)
+{
+	// Erä kopioidaan lähetyspuskuriin yhdellä kirjoituksella, täydessä
+	// puskurissa EventThread nukkuu, kunnes keskeytys on lähettänyt tilaa
+	sarja.kirjoitaKaikki(loki_era, *kohta);
+	*kohta = 0;
+}
 
-	if(type == 1)
-    {
-		for(std::string::size_type i = 0; i<viesti.size();i++)
+void lisaaEraan(uint8_t tavu, void* kohta)
+{
+	// Kehykset koodataan suoraan erään, täysi erä kirjoitetaan välissä
+	if (*(int*)kohta == LOKI_ERA)
+		kirjoitaEra((int*)kohta);
+	loki_era[(*(int*)kohta)++] = (char)tavu;
+}
+
+void tyhjennaLoki()
+{
+	int kohta = 0;
+	const LokiTietue* tietue;
+	while ((tietue = loki.seuraava()))
+	{
+		// Tietue ei mahdu erään: data tulostetaan lukuina (enintään 5
+		// merkkiä bytelle), viesti sellaisenaan ja perään rivinvaihto.
+		// Kehys kirjoitetaan tarvittaessa kahdessa erässä.
+		int pisin = tietue->koko + 3;
+		if (tietue->tyyppi == LokiRengas::DATA)
+			pisin = 5 * tietue->koko + 3;
+		else if (tietue->tyyppi == LokiRengas::JALJITYS)
+			pisin = JALJITYS_BINAARI ? 0 : JALJITYS_RIVI + 3;
+		if (kohta + pisin > LOKI_ERA)
+			kirjoitaEra(&kohta);
+
+		if (tietue->tyyppi == LokiRengas::JALJITYS)
 		{
-		   pc.printf("%i ",(int8_t) viesti[i]);
+			uint32_t sanat[1 + JALJITYS_MAX_ARGUMENTTEJA];
+			int sanoja = tietue->koko / 4;
+			memcpy(sanat, tietue->data, 4 * sanoja);
+			loki.vapauta();
+#if JALJITYS_BINAARI
+			kehystaJaljitys(sanat, sanoja, lisaaEraan, &kohta);
+			continue;
+#else
+			kohta += muotoileJaljitys(&loki_era[kohta], JALJITYS_RIVI + 1, sanat, sanoja);
+#endif
 		}
-		pc.printf("\r\n");  // print new line
+		else
+		{
+			if (tietue->tyyppi == LokiRengas::DATA)
+			{
+				for (int i = 0; i < tietue->koko; i++)
+					kohta += sprintf(&loki_era[kohta], "%i ", (int8_t)tietue->data[i]);
+			}
+			else
+			{
+				memcpy(&loki_era[kohta], tietue->data, tietue->koko);
+				kohta += tietue->koko;
+			}
+			loki.vapauta();
+		}
+		loki_era[kohta++] = '\r';
+		loki_era[kohta++] = '\n';
 	}
-	else
-    {
-		pc.printf("%s\r\n",viesti.c_str());
-	}	
 
+	// Täyden renkaan takia pudotetuista kerrotaan, kun niitä on tullut lisää
+	uint32_t pudotettuja = loki.pudotettuja();
+	if (pudotettuja != loki_pudotettuja)
+	{
+		if (kohta + 48 > LOKI_ERA)
+			kirjoitaEra(&kohta);
+		kohta += sprintf(&loki_era[kohta], "loki: pudotettu %u tietuetta\r\n", (unsigned int)(pudotettuja - loki_pudotettuja));
+		loki_pudotettuja = pudotettuja;
+	}
+	kirjoitaEra(&kohta);
+}
+
+void tulostaKuva(const uint8_t* kuva, uint32_t pituus, bool kunnossa)
+{
+	// Kuvaa edeltäneet tietueet tulostetaan ensin
+	tyhjennaLoki();
+
+	int kohta = 0;
+#if BINAARITULOSTE
+	kehystaKuva(kuva, pituus, kunnossa ? SARJAKEHYS_KUNNOSSA : SARJAKEHYS_VIRHEELLINEN, lisaaEraan, &kohta);
+#else
+	for (uint32_t i = 0; i < pituus; i++)
+	{
+		if (kohta + 6 > LOKI_ERA)		// "%i " ja sprintf:n lopettava nolla
+			kirjoitaEra(&kohta);
+		kohta += sprintf(&loki_era[kohta], "%i ", (int8_t)kuva[i]);
+	}
+	if (kohta + 2 > LOKI_ERA)
+		kirjoitaEra(&kohta);
+	loki_era[kohta++] = '\r';
+	loki_era[kohta++] = '\n';
+#endif
+	kirjoitaEra(&kohta);
+	kuva_tulostettu.release();
 }
-void printMsg(string msg)
+
+void printMsg(const char* msg)
 {
-	event.post(msg,0);  // msgType = 0 eli oikea C++ character string
+	loki.kirjoita(LokiRengas::VIESTI, msg, strlen(msg));
 }
-void printData(string msg)
+
+void printData(const void* data, int koko)
 {
-	event.post(msg,1);  // msgType = 1 eli int8_t dataa
+	loki.kirjoita(LokiRengas::DATA, data, koko);  // int8_t dataa, tulostetaan lukuina
 }
 
+void jaljitaTietue(const uint32_t* sanat, int sanoja)
+{
+	loki.kirjoita(LokiRengas::JALJITYS, sanat, 4 * sanoja);
+}
+
+void printImage(const void* kuva, uint32_t pituus, bool kunnossa)
+{
+	// Kuva tulostetaan EventThreadilla, jotta se ei sekoitu lokin
+	// tulosteeseen, ja odotetaan, että kuvan muistin voi taas käyttää
+	if (queue.call(tulostaKuva, (const uint8_t*)kuva, pituus, kunnossa))
+		kuva_tulostettu.wait();
+}
@@ -4,7 +4,9 @@
 */
 
 extern EventQueue queue;
-extern Serial pc;
-void printMsg(string msg);
-void printData(string msg);
-void kasaaPaketti(int);
\ No newline at end of file
+class SarjaPuskuri;
+extern SarjaPuskuri sarja;
+void printMsg(const char* msg);
+void printData(const void* data, int koko);
+void printImage(const void* kuva, uint32_t pituus, bool kunnossa);
+int kasaaPaketti(int8_t*, uint32_t, int, uint8_t);
\ No newline at end of file
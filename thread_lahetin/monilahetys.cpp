@@ -0,0 +1,177 @@
+#include "monilahetys.h"
+#include <string.h>
+
+int moniPaloja(uint32_t koko)
+{
+	return (int)((koko + MONI_PALAN_KOKO - 1) / MONI_PALAN_KOKO);
+}
+
+uint64_t moniKaikki(int k)
+{
+	if (k <= 0)
+		return 0;
+	return k >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << k) - 1;
+}
+
+int moniMaara(uint64_t palat)
+{
+	int maara = 0;
+	for (; palat; palat &= palat - 1)
+		maara++;
+	return maara;
+}
+
+int kasaaNack(uint8_t* kohde, uint8_t siirto, uint64_t palat)
+{
+	// Peräkkäiset puuttuvat palat ovat yksi alue
+	int alueita = 0;
+	int i = 0;
+	while (i < MONI_MAX_PALOJA && alueita < NACK_MAX_ALUEITA) {
+		if (!((palat >> i) & 1)) {
+			i++;
+			continue;
+		}
+		int alku = i;
+		while (i < MONI_MAX_PALOJA && ((palat >> i) & 1))
+			i++;
+		kirjoitaU16((int8_t *)&kohde[2 + 4 * alueita], (uint16_t)alku);
+		kirjoitaU16((int8_t *)&kohde[4 + 4 * alueita], (uint16_t)(i - alku));
+		alueita++;
+	}
+	if (!alueita)
+		return 0;
+	kohde[0] = NACK_TUNNISTE;
+	kohde[1] = siirto;
+	return NACK_KOKO(alueita);
+}
+
+bool onNack(const uint8_t* paketti, int koko)
+{
+	return koko >= NACK_KOKO(1) && koko <= NACK_KOKO(NACK_MAX_ALUEITA) &&
+		(koko - NACK_KOKO(0)) % 4 == 0 && paketti[0] == NACK_TUNNISTE;
+}
+
+uint64_t lueNack(const uint8_t* paketti, int koko, uint8_t siirto)
+{
+	if (!onNack(paketti, koko) || paketti[1] != siirto)
+		return 0;
+	uint64_t palat = 0;
+	for (int a = 0; a < (koko - NACK_KOKO(0)) / 4; a++) {
+		uint32_t alku = lueU16(&paketti[2 + 4 * a]);
+		uint32_t loppu = alku + lueU16(&paketti[4 + 4 * a]);
+		for (uint32_t i = alku; i < loppu && i < MONI_MAX_PALOJA; i++)
+			palat |= (uint64_t)1 << i;
+	}
+	return palat;
+}
+
+MoniVastaanotto::MoniVastaanotto()
+{
+	aloita(-1, 0, 1);
+}
+
+void MoniVastaanotto::aloita(int siirto, int k, uint32_t siemen)
+{
+	_siirto = siirto;
+	_k = k < MONI_MAX_PALOJA ? k : MONI_MAX_PALOJA;
+	_saadut = 0;
+	_pyydettavat = 0;
+	_odottaa = false;
+	_lahtee = 0;
+	// xorshift ei saa alkaa nollasta
+	_satunnainen = siemen ? siemen : 1;
+	_nackeja = 0;
+	_vaimennettuja = 0;
+}
+
+int MoniVastaanotto::siirto()
+{
+	return _siirto;
+}
+
+int MoniVastaanotto::k()
+{
+	return _k;
+}
+
+bool MoniVastaanotto::lisaa(int numero, const uint8_t* pala, int koko)
+{
+	if (numero < 0 || numero >= _k || koko > MONI_PALAN_KOKO || ((_saadut >> numero) & 1))
+		return false;
+	memcpy(_palat[numero], pala, koko);
+	_saadut |= (uint64_t)1 << numero;
+	return true;
+}
+
+bool MoniVastaanotto::valmis()
+{
+	return _k > 0 && _saadut == moniKaikki(_k);
+}
+
+int MoniVastaanotto::saatuja()
+{
+	return moniMaara(_saadut);
+}
+
+const uint8_t* MoniVastaanotto::pala(int i)
+{
+	return _palat[i];
+}
+
+uint32_t MoniVastaanotto::satunnainen()
+{
+	// xorshift32
+	uint32_t x = _satunnainen;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	_satunnainen = x;
+	return x;
+}
+
+void MoniVastaanotto::kierrosLahetetty(uint32_t nyt)
+{
+	// Jo odottava NACK lähtee alkuperäiseen aikaan, muuten arvotaan
+	// viive, jotta vastaanottimet eivät lähetä samaan aikaan
+	uint64_t puuttuvat = moniKaikki(_k) & ~_saadut;
+	if (!puuttuvat || _odottaa)
+		return;
+	_pyydettavat = puuttuvat;
+	_lahtee = nyt + satunnainen() % (MONI_NACK_VIIVE + 1);
+	_odottaa = true;
+}
+
+void MoniVastaanotto::kuultuNack(uint64_t palat)
+{
+	if (!_odottaa)
+		return;
+	_pyydettavat &= ~palat;
+	if (!_pyydettavat) {
+		_odottaa = false;
+		_vaimennettuja++;
+	}
+}
+
+int MoniVastaanotto::nack(uint32_t nyt, uint8_t* kohde)
+{
+	if (!_odottaa || (int32_t)(nyt - _lahtee) < 0)
+		return 0;
+	_odottaa = false;
+
+	// Odotuksen aikana tulleita paloja ei enää pyydetä
+	_pyydettavat &= ~_saadut;
+	int koko = kasaaNack(kohde, (uint8_t)_siirto, _pyydettavat);
+	if (koko)
+		_nackeja++;
+	return koko;
+}
+
+unsigned int MoniVastaanotto::nackeja()
+{
+	return _nackeja;
+}
+
+unsigned int MoniVastaanotto::vaimennettuja()
+{
+	return _vaimennettuja;
+}
@@ -0,0 +1,105 @@
+/*
+* Monilähetys usealle vastaanottimelle negatiivisilla kuittauksilla (NACK)
+*
+* Lähetin lähettää kuvan palat ryhmäosoitteeseen (RYHMAOSOITE) kerran ja
+* kierroksen lopuksi tietopaketin. Vastaanottimet eivät kuittaa saatuja,
+* vaan pyytävät tietopaketin jälkeen NACKilla vain puuttuvat palat
+* alueina. NACK lähtee satunnaisen viiveen jälkeen ryhmäosoitteeseen,
+* joten muut vastaanottimet kuulevat sen: jos kuultu NACK pyytää samat
+* palat, oma NACK jää lähettämättä (vaimennus), ja usein kadonnut pala
+* pyydetään vain kerran, vaikka vastaanottimia olisi monta.
+*
+* Lähetin yhdistää korjausikkunan aikana kuullut NACKit ja lähettää
+* pyydetyt palat seuraavalla kierroksella kerran. Siirto päättyy, kun
+* kierroksen jälkeen ei tule NACKeja, joten siirron kesto riippuu
+* kadonneista paloista eikä vastaanottimien määrästä.
+*
+* Palat ovat kiinteän kokoisia (viimeinen lyhyempi), pala i alkaa kohdasta
+* i * MONI_PALAN_KOKO. Palojen joukot pidetään 64-bittisessä maskissa.
+*/
+
+#ifndef MONILAHETYS_H
+#define MONILAHETYS_H
+
+#include <stdint.h>
+#include "protokolla.h"
+
+#define MONI_PALAN_KOKO MAX_PACKET_DATA_SIZE
+#define MONI_MAX_PALOJA 64
+
+// Vastaanotin odottaa ennen NACKia satunnaisen ajan 0..MONI_NACK_VIIVE ms.
+// Viiveen pitää olla useamman NACKin lähetysajan pituinen, jotta
+// vastaanottimet ehtivät kuulla toistensa NACKit.
+#define MONI_NACK_VIIVE 1000
+
+// Montako palaa koko datalle tarvitaan
+int moniPaloja(uint32_t koko);
+
+// Palat 0..k-1
+uint64_t moniKaikki(int k);
+
+// Maskin palojen määrä
+int moniMaara(uint64_t palat);
+
+// Kasataan kohteeseen NACK palojen alueista alimmasta alkaen, enintään
+// NACK_MAX_ALUEITA aluetta (loput pyydetään seuraavalla kierroksella).
+// Palauttaa NACKin koon, 0 jos palat on tyhjä.
+int kasaaNack(uint8_t* kohde, uint8_t siirto, uint64_t palat);
+
+// Onko paketti NACK
+bool onNack(const uint8_t* paketti, int koko);
+
+// Siirron siirto NACKin pyytämät palat, 0 jos NACK on toisesta siirrosta
+uint64_t lueNack(const uint8_t* paketti, int koko, uint8_t siirto);
+
+/*
+* Vastaanotin: kerää palat ja ajoittaa NACKit
+*/
+class MoniVastaanotto
+{
+public:
+	MoniVastaanotto();
+
+	// Uusi siirto k palasta, siemen satunnaisille viiveille.
+	// siirto = -1 tarkoittaa, ettei siirtoa ole aloitettu.
+	void aloita(int siirto, int k, uint32_t siemen);
+	int siirto();
+	int k();
+
+	// Pala numero, palauttaa false, jos se on jo saatu tai ei kuulu siirtoon
+	bool lisaa(int numero, const uint8_t* pala, int koko);
+	bool valmis();
+	int saatuja();
+	const uint8_t* pala(int i);
+
+	// Lähetin on lähettänyt kierroksen (tietopaketti), puuttuvat pyydetään
+	// satunnaisen viiveen jälkeen ajassa nyt (ms)
+	void kierrosLahetetty(uint32_t nyt);
+
+	// Toisen vastaanottimen NACK pyytää palat, niitä ei pyydetä uudelleen
+	void kuultuNack(uint64_t palat);
+
+	// Jos NACKin aika on tullut, kasataan se kohteeseen ja palautetaan
+	// koko, muuten 0
+	int nack(uint32_t nyt, uint8_t* kohde);
+
+	// Lähetetyt ja vaimennetut (kuultu NACK pyysi kaikki) NACKit
+	unsigned int nackeja();
+	unsigned int vaimennettuja();
+
+private:
+	uint32_t satunnainen();
+
+	int _siirto;
+	int _k;
+	uint64_t _saadut;
+	uint64_t _pyydettavat;		// odottavan NACKin palat
+	bool _odottaa;
+	uint32_t _lahtee;			// odottavan NACKin lähetysaika (ms)
+	uint32_t _satunnainen;
+	unsigned int _nackeja;
+	unsigned int _vaimennettuja;
+	uint8_t _palat[MONI_MAX_PALOJA][MONI_PALAN_KOKO];
+};
+
+#endif
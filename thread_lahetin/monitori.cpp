@@ -0,0 +1,113 @@
+#include "monitori.h"
+#include <string.h>
+
+Monitori::Monitori()
+{
+	_threadeja = 0;
+	_keskeytyksia = 0;
+	_naytteita = 0;
+	_naytteita_raportoitu = 0;
+	_muita = 0;
+	_muita_raportoitu = 0;
+	_raportoitu_ms = 0;
+}
+
+void Monitori::lisaa(Thread* thread, JaljitysId viesti, unsigned char* pino, uint32_t koko)
+{
+	if (_threadeja == MONITORI_THREADEJA)
+		return;
+	Seurattava* s = &_threadit[_threadeja++];
+	s->thread = thread;
+	s->id = thread ? 0 : ThisThread::get_id();
+	s->viesti = viesti;
+	s->pino = pino;
+	s->koko = pino ? koko : 0;
+	s->naytteita = 0;
+	s->raportoitu = 0;
+	if (pino)
+		memset(pino, (uint8_t)MONITORI_KUVIO, koko);
+}
+
+void Monitori::lisaaKeskeytys(JaljitysId viesti, Laskurit laskurit)
+{
+	if (_keskeytyksia == MONITORI_KESKEYTYKSIA)
+		return;
+	Keskeytys* k = &_keskeytykset[_keskeytyksia++];
+	k->viesti = viesti;
+	k->laskurit = laskurit;
+	laskurit(&k->kertoja, &k->jaksoja);
+}
+
+void Monitori::aloita()
+{
+	// Threadien tunnisteet ovat olemassa vasta käynnistyksen jälkeen
+	for (int i = 0; i < _threadeja; i++)
+		if (_threadit[i].thread)
+			_threadit[i].id = _threadit[i].thread->get_id();
+	_aika.start();
+	_raportoitu_ms = _aika.read_ms();
+	_naytteet.attach_us(callback(this, &Monitori::nayte), MONITORI_NAYTEVALI);
+}
+
+void Monitori::nayte()
+{
+	osThreadId ajossa = ThisThread::get_id();
+	_naytteita++;
+	for (int i = 0; i < _threadeja; i++) {
+		if (_threadit[i].id == ajossa) {
+			_threadit[i].naytteita++;
+			return;
+		}
+	}
+	_muita++;
+}
+
+uint32_t Monitori::pinoaKaytetty(int i)
+{
+	const uint32_t* sanat = (const uint32_t*)_threadit[i].pino;
+	uint32_t sanoja = _threadit[i].koko / 4;
+	if (!sanoja)
+		return 0;
+	uint32_t koskematon = 1;
+	while (koskematon < sanoja && sanat[koskematon] == MONITORI_KUVIO)
+		koskematon++;
+	return (sanoja - koskematon) * 4;
+}
+
+static uint32_t promillea(uint32_t osa, uint32_t kaikki)
+{
+	return kaikki ? (uint32_t)((uint64_t)osa * 1000 / kaikki) : 0;
+}
+
+void Monitori::raportoi(JaljitysId muut)
+{
+	uint32_t naytteita = _naytteita;
+	uint32_t kaikki = naytteita - _naytteita_raportoitu;
+	_naytteita_raportoitu = naytteita;
+
+	for (int i = 0; i < _threadeja; i++) {
+		Seurattava* s = &_threadit[i];
+		uint32_t n = s->naytteita;
+		uint32_t osuus = promillea(n - s->raportoitu, kaikki);
+		s->raportoitu = n;
+		jaljita(s->viesti, osuus / 10, osuus % 10, pinoaKaytetty(i), s->koko);
+	}
+	uint32_t muita = _muita;
+	uint32_t osuus = promillea(muita - _muita_raportoitu, kaikki);
+	_muita_raportoitu = muita;
+	jaljita(muut, osuus / 10, osuus % 10);
+
+	// Keskeytysten kellojaksot suhteessa raporttien väliin kuluneisiin jaksoihin
+	uint32_t nyt = _aika.read_ms();
+	uint64_t jaksoja = (uint64_t)(nyt - _raportoitu_ms) * (SystemCoreClock / 1000);
+	_raportoitu_ms = nyt;
+	for (int i = 0; i < _keskeytyksia; i++) {
+		Keskeytys* k = &_keskeytykset[i];
+		uint32_t kertoja, kellojaksoja;
+		k->laskurit(&kertoja, &kellojaksoja);
+		uint32_t osuus = jaksoja ? (uint32_t)((uint64_t)(kellojaksoja - k->jaksoja) * 1000 / jaksoja) : 0;
+		jaljita(k->viesti, osuus / 10, osuus % 10, kertoja - k->kertoja);
+		k->kertoja = kertoja;
+		k->jaksoja = kellojaksoja;
+	}
+}
@@ -0,0 +1,97 @@
+/*
+* Threadien prosessoriajan, pinojen ja keskeytysten seuranta
+*
+* Prosessoriaika mitataan näytteillä: tickerin keskeytys katsoo
+* MONITORI_NAYTEVALI µs välein, mikä thread oli ajossa (keskeytyksestä
+* kysyttynä ThisThread::get_id on keskeytetty thread), ja kasvattaa sen
+* laskuria. Threadin näytteiden osuus on sen osuus prosessoriajasta,
+* seuraamattomat threadit (idle, RTOS:n ajastimet) lasketaan yhteen.
+* Näyteväli ei ole millisekunnin monikerta, jotta millisekunnin välein
+* heräävät threadit eivät osu aina samaan kohtaan näytteissä.
+*
+* Pinon käyttö: pino maalataan kuviolla ennen threadin käynnistystä, ja
+* suurin käyttö on se osa pinosta, jonka kuvio on ylikirjoitettu. Pino
+* kasvaa alaspäin, joten koskematon osa on pinon alussa. RTX kirjoittaa
+* pinon ensimmäiseen sanaan tarkistusarvon, joten se ohitetaan.
+*
+* Keskeytysten aika luetaan ask-lähettimien ja -vastaanottimien
+* laskureista (interrupt_cycles), lähteet annetaan funktioina.
+*
+* Raportti kirjoitetaan jäljitystietueina (jaljitys.h), rivi threadia ja
+* keskeytyslähdettä kohti, osuudet edellisestä raportista lähtien.
+*/
+
+#ifndef MONITORI_H
+#define MONITORI_H
+
+#include "mbed.h"
+#include <stdint.h>
+#include "jaljitys.h"
+
+#define MONITORI_THREADEJA 6
+#define MONITORI_KESKEYTYKSIA 4
+#define MONITORI_NAYTEVALI 997		// µs
+#define MONITORI_KUVIO 0xCCCCCCCC	// sama kuin RTX:n pinon maalaus
+
+class Monitori
+{
+public:
+	// Keskeytyslähteen kerrat ja prosessorin kellojaksot (SystemCoreClock)
+	// alusta lähtien, saavat pyörähtää ympäri
+	typedef void (*Laskurit)(uint32_t* kertoja, uint32_t* jaksoja);
+
+	Monitori();
+
+	// Thread seurantaan ennen käynnistystä, pino maalataan. Raportin rivi
+	// on viesti(cpu %, cpu ‰ jakojäännös, pinoa käytetty, pinon koko).
+	// thread = 0 on kutsuva thread (main), sen pinoa ei seurata.
+	void lisaa(Thread* thread, JaljitysId viesti, unsigned char* pino, uint32_t koko);
+
+	// Raportin rivi on viesti(cpu %, cpu ‰ jakojäännös, kertoja)
+	void lisaaKeskeytys(JaljitysId viesti, Laskurit laskurit);
+
+	// Threadien käynnistyksen jälkeen, näytteiden otto alkaa
+	void aloita();
+
+	// Raportti edellisestä raportista lähtien, muut threadit viestillä muut
+	void raportoi(JaljitysId muut);
+
+	// Seurattavan threadin i pinosta suurimmillaan käytetty (byteä)
+	uint32_t pinoaKaytetty(int i);
+
+private:
+	struct Seurattava
+	{
+		Thread* thread;
+		osThreadId id;
+		JaljitysId viesti;
+		unsigned char* pino;
+		uint32_t koko;
+		volatile uint32_t naytteita;
+		uint32_t raportoitu;		// näytteitä edellisessä raportissa
+	};
+
+	struct Keskeytys
+	{
+		JaljitysId viesti;
+		Laskurit laskurit;
+		uint32_t kertoja;			// edellisessä raportissa
+		uint32_t jaksoja;
+	};
+
+	void nayte();
+
+	Seurattava _threadit[MONITORI_THREADEJA];
+	int _threadeja;
+	Keskeytys _keskeytykset[MONITORI_KESKEYTYKSIA];
+	int _keskeytyksia;
+	volatile uint32_t _naytteita;
+	uint32_t _naytteita_raportoitu;
+	volatile uint32_t _muita;
+	uint32_t _muita_raportoitu;
+	Ticker _naytteet;
+	Timer _aika;
+	uint32_t _raportoitu_ms;
+};
+
+#endif
@@ -0,0 +1,221 @@
+#include "pakkaus.h"
+
+// _ikkunan_kohta on 8-bittinen ja pyörähtää ympäri ikkunan lopussa
+#if PAKKAUS_IKKUNA != 256
+#error PAKKAUS_IKKUNA pitää olla 256
+#endif
+
+const char* pakkauksenNimi(Pakkaus menetelma)
+{
+	switch (menetelma) {
+		case PAKKAUS_RLE:
+			return "RLE";
+		case PAKKAUS_LZ77:
+			return "LZ77";
+		default:
+			return "ei pakkausta";
+	}
+}
+
+static int pakkaaRLE(const uint8_t* lahde, int koko, uint8_t* kohde, int kohteen_koko)
+{
+	int i = 0;
+	int k = 0;
+	while (i < koko) {
+		// Toistuvien bytejen määrä kohdasta i
+		int toisto = 1;
+		while (i + toisto < koko && toisto < 128 && lahde[i + toisto] == lahde[i])
+			toisto++;
+
+		if (toisto >= 2) {
+			if (k + 2 > kohteen_koko)
+				return -1;
+			kohde[k++] = (uint8_t)(257 - toisto);
+			kohde[k++] = lahde[i];
+			i += toisto;
+		}
+		else {
+			// Bytet sellaisenaan seuraavaan toistoon asti
+			int alku = i;
+			while (i < koko && i - alku < 128 && !(i + 1 < koko && lahde[i + 1] == lahde[i]))
+				i++;
+			if (i == alku)
+				i++;
+			int maara = i - alku;
+			if (k + 1 + maara > kohteen_koko)
+				return -1;
+			kohde[k++] = (uint8_t)(maara - 1);
+			for (int j = 0; j < maara; j++)
+				kohde[k++] = lahde[alku + j];
+		}
+	}
+	return k;
+}
+
+static int pakkaaLZ77(const uint8_t* lahde, int koko, uint8_t* kohde, int kohteen_koko)
+{
+	int i = 0;
+	int k = 0;
+	int lippukohta = 0;
+	int lippuja = 8;
+
+	while (i < koko) {
+		// Uusi lippubyte jokaista 8 alkiota kohden
+		if (lippuja == 8) {
+			if (k >= kohteen_koko)
+				return -1;
+			lippukohta = k;
+			kohde[k++] = 0;
+			lippuja = 0;
+		}
+
+		// Etsitään pisin vastaavuus ikkunasta
+		int paras_pituus = 0;
+		int paras_etaisyys = 0;
+		for (int etaisyys = 1; etaisyys <= PAKKAUS_IKKUNA && etaisyys <= i; etaisyys++) {
+			int pituus = 0;
+			while (i + pituus < koko && pituus < PAKKAUS_MAX_VIITTAUS && lahde[i + pituus] == lahde[i + pituus - etaisyys])
+				pituus++;
+			if (pituus > paras_pituus) {
+				paras_pituus = pituus;
+				paras_etaisyys = etaisyys;
+			}
+		}
+
+		if (paras_pituus >= PAKKAUS_MIN_VIITTAUS) {
+			if (k + 2 > kohteen_koko)
+				return -1;
+			kohde[lippukohta] |= (uint8_t)(1 << lippuja);
+			kohde[k++] = (uint8_t)(paras_etaisyys - 1);
+			kohde[k++] = (uint8_t)(paras_pituus - PAKKAUS_MIN_VIITTAUS);
+			i += paras_pituus;
+		}
+		else {
+			if (k >= kohteen_koko)
+				return -1;
+			kohde[k++] = lahde[i++];
+		}
+		lippuja++;
+	}
+	return k;
+}
+
+int pakkaa(Pakkaus menetelma, const uint8_t* lahde, int koko, uint8_t* kohde, int kohteen_koko)
+{
+	switch (menetelma) {
+		case PAKKAUS_RLE:
+			return pakkaaRLE(lahde, koko, kohde, kohteen_koko);
+		case PAKKAUS_LZ77:
+			return pakkaaLZ77(lahde, koko, kohde, kohteen_koko);
+		default:
+			if (koko > kohteen_koko)
+				return -1;
+			for (int i = 0; i < koko; i++)
+				kohde[i] = lahde[i];
+			return koko;
+	}
+}
+
+Purkaja::Purkaja()
+{
+	aloita(PAKKAUS_EI, 0, 0);
+}
+
+void Purkaja::aloita(Pakkaus menetelma, Ulos ulos, void* konteksti)
+{
+	_menetelma = menetelma;
+	_ulos = ulos;
+	_konteksti = konteksti;
+	_tila = menetelma == PAKKAUS_LZ77 ? LZ_ALKIO : OHJAUS;
+	_jaljella = 0;
+	_liput = 0;
+	_lippuja = 0;
+	_etaisyys = 0;
+	_purettu = 0;
+	_ikkunan_kohta = 0;
+}
+
+void Purkaja::kirjoita(uint8_t tavu)
+{
+	_ikkuna[_ikkunan_kohta++] = tavu;
+	_purettu++;
+	if (_ulos)
+		_ulos(tavu, _konteksti);
+}
+
+bool Purkaja::pura(const uint8_t* data, int koko)
+{
+	for (int i = 0; i < koko; i++) {
+		uint8_t tavu = data[i];
+
+		switch (_menetelma) {
+			case PAKKAUS_RLE:
+				if (_tila == OHJAUS) {
+					if (tavu < 128) {
+						_tila = SELLAISENAAN;
+						_jaljella = tavu + 1;
+					}
+					else if (tavu > 128) {
+						_tila = TOISTO;
+						_jaljella = 257 - tavu;
+					}
+					// 128 ei tee mitään (PackBits)
+				}
+				else if (_tila == SELLAISENAAN) {
+					kirjoita(tavu);
+					if (--_jaljella == 0)
+						_tila = OHJAUS;
+				}
+				else {
+					while (_jaljella--)
+						kirjoita(tavu);
+					_tila = OHJAUS;
+				}
+				break;
+
+			case PAKKAUS_LZ77:
+				if (_tila == LZ_ALKIO && _lippuja == 0) {
+					// Lippubyte kertoo seuraavien 8 alkion tyypin
+					_liput = tavu;
+					_lippuja = 8;
+				}
+				else if (_tila == LZ_ALKIO) {
+					if (_liput & 1) {
+						// Viittaus ei voi osoittaa datan alkua aiemmaksi
+						if ((uint32_t)tavu >= _purettu)
+							return false;
+						_etaisyys = tavu;
+						_tila = LZ_PITUUS;
+					}
+					else {
+						kirjoita(tavu);
+					}
+					_liput >>= 1;
+					_lippuja--;
+				}
+				else {
+					// Kopioidaan viittaus ikkunasta byte kerrallaan,
+					// jolloin myös itseensä menevät viittaukset toimivat
+					int pituus = tavu + PAKKAUS_MIN_VIITTAUS;
+					for (int j = 0; j < pituus; j++)
+						kirjoita(_ikkuna[(uint8_t)(_ikkunan_kohta - 1 - _etaisyys)]);
+					_tila = LZ_ALKIO;
+				}
+				break;
+
+			default:
+				kirjoita(tavu);
+				break;
+		}
+	}
+	return true;
+}
+
+bool Purkaja::valmis()
+{
+	if (_menetelma == PAKKAUS_RLE)
+		return _tila == OHJAUS;
+	if (_menetelma == PAKKAUS_LZ77)
+		return _tila == LZ_ALKIO;
+	return true;
+}
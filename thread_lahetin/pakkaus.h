@@ -0,0 +1,71 @@
+/*
+* Kuvan pakkaus ennen paketointia ja purku vastaanottimella
+*
+* Lähetin pakkaa koko kuvan kerralla ennen ensimmäistä pakettia,
+* vastaanotin purkaa dataa sitä mukaa kuin paloja tulee järjestyksessä
+* perille. Purkaja ei tarvitse koko kuvaa muistiin: LZ77 muistaa vain
+* PAKKAUS_IKKUNA viimeistä purettua byteä.
+*
+* RLE (PackBits):
+* 	ohjausbyte h = 0..127		h+1 seuraavaa byteä sellaisenaan
+* 	ohjausbyte h = 129..255		seuraava byte toistetaan 257-h kertaa
+*
+* LZ77 (LZSS):
+* 	lippubyte, jonka bitit kertovat seuraavien 8 alkion tyypin
+* 	(vähiten merkitsevä ensin, 0 = byte sellaisenaan, 1 = viittaus)
+* 	viittaus on 2 byteä: etäisyys-1 (0..255) ja pituus-3 (0..255)
+*/
+
+#ifndef PAKKAUS_H
+#define PAKKAUS_H
+
+#include <stdint.h>
+
+#define PAKKAUS_IKKUNA 256
+#define PAKKAUS_MIN_VIITTAUS 3
+#define PAKKAUS_MAX_VIITTAUS (PAKKAUS_MIN_VIITTAUS + 255)
+
+enum Pakkaus { PAKKAUS_EI = 0, PAKKAUS_RLE = 1, PAKKAUS_LZ77 = 2 };
+
+const char* pakkauksenNimi(Pakkaus menetelma);
+
+// Pakkaa lähteen kohteeseen, palauttaa pakatun koon tai -1,
+// jos pakattu data ei mahdu kohteeseen
+int pakkaa(Pakkaus menetelma, const uint8_t* lahde, int koko, uint8_t* kohde, int kohteen_koko);
+
+class Purkaja
+{
+public:
+	// Purettu data annetaan byte kerrallaan tälle funktiolle
+	typedef void (*Ulos)(uint8_t tavu, void* konteksti);
+
+	Purkaja();
+
+	void aloita(Pakkaus menetelma, Ulos ulos, void* konteksti);
+
+	// Puretaan seuraava pala pakattua dataa, palauttaa false,
+	// jos data ei ole kelvollista
+	bool pura(const uint8_t* data, int koko);
+
+	// Onko viimeinen alkio kokonaan purettu (eikä kesken jäänyttä viittausta tms.)
+	bool valmis();
+
+private:
+	enum Tila { OHJAUS, SELLAISENAAN, TOISTO, LZ_ALKIO, LZ_PITUUS };
+
+	void kirjoita(uint8_t tavu);
+
+	Pakkaus _menetelma;
+	Ulos _ulos;
+	void* _konteksti;
+	Tila _tila;
+	int _jaljella;			// RLE: jäljellä olevat bytet
+	uint8_t _liput;			// LZ77: lippubyte
+	uint8_t _lippuja;		// LZ77: lippubytestä käyttämättä olevat bitit
+	uint8_t _etaisyys;		// LZ77: viittauksen etäisyys-1
+	uint32_t _purettu;		// purettujen bytejen määrä
+	uint8_t _ikkuna[PAKKAUS_IKKUNA];
+	uint8_t _ikkunan_kohta;
+};
+
+#endif
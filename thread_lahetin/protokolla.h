@@ -0,0 +1,195 @@
+/*
+* Lähettimen (lahetin.cpp) ja vastaanottimen (vastaanotin.cpp) yhteinen
+* pakettimuoto
+*/
+
+#ifndef PROTOKOLLA_H
+#define PROTOKOLLA_H
+
+#include <stdint.h>
+#include "ask_receiver.h"
+
+/********************************************************
+ * Headerin (6 byteä) rakenne:
+ *
+ * 	message[0]		liput
+ * 					bitti 7: tietopaketin lippu, 1 tietopaketissa
+ * 					bitti 6: viimeisen paketin lippu, 1 viimeisessä paketissa
+ * 					bitti 5: pariteettipaketin lippu, 1 pariteettipaketissa (fec.h)
+ * 					bitti 4: yleislähetyksen lippu, 1 suihkulähdekoodatussa
+ * 					yleislähetyksessä (suihkulahde.h)
+ * 					bitti 3: kuittauspyyntö, 1 lähetyksen viimeisessä paketissa
+ * 					bitit 0-2: pariteettipakettien määrä P (vain pariteettipaketissa)
+ * 	message[1]		datan koko (byteä)
+ * 	message[2..3]	datan alkukohdan alimmat 16 bittiä (little endian),
+ * 					vastaanotin päättelee ylemmät bitit järjestyksessä
+ * 					saadun datan määrästä (pariteettipaketissa ryhmän
+ * 					ensimmäisen paketin alkukohta)
+ * 	message[4]		paketin järjestysnumero, kasvaa yhdellä jokaista uutta
+ * 					datapakettia kohden, pyörähtää ympäri
+ * 					(pariteettipaketissa ryhmän ensimmäisen paketin järjestysnumero,
+ * 					tietopaketissa siirron ensimmäisen paketin järjestysnumero)
+ * 	message[5]		bitit 4-7: paketin indeksi ryhmässä (pariteettipaketissa
+ * 					pariteetin indeksi), bitit 0-3: ryhmän pakettien määrä K - 1
+ *
+ * Paketti lähetetään aina todellisen kokoisena, viimeistä palaa
+ * ei täytetä nollilla. Palan koko voi vaihdella paketista toiseen
+ * (kokosaadin.h), koska vastaanotin kirjoittaa datan alkukohdan mukaan.
+ * Datapaketit lähetetään K paketin ryhminä, joita seuraa P pariteettipakettia
+ * (fec.h) ja vastaanotin kuittaa koko ryhmän kerralla.
+ *
+ * Kuittaus (ACK_SIZE byteä):
+ *
+ * 	ack[0]			ACK_TUNNISTE, tietopaketin kuittauksessa lisäksi ACK_INFO_FLAG
+ * 	ack[1]			kumulatiivinen kuittaus: seuraavan odotetun paketin
+ * 					järjestysnumero, kaikki sitä edeltävät on saatu
+ * 	ack[2..3]		valikoiva kuittaus (SACK): bitti i = paketti ack[1] + i
+ * 					on saatu (16-bittinen, little endian)
+ * 	ack[4..5]		ikkuna: montako byteä dataa kuitatun kohdan jälkeen
+ * 					vastaanotin ottaa vastaan (16-bittinen, little endian)
+ *
+ * Vastaanotin kuittaa valmiin ryhmän ja tietopaketin heti, kesken olevan
+ * ryhmän vain kuittauspyynnöstä. Lähetin lähettää uudelleen vain paketit,
+ * joita ei ole kuitattu, ja ohittaa kuittaukset, joiden järjestysnumero
+ * on vanhempi kuin lähetettävän ryhmän.
+ *
+ * Ikkuna lasketaan kokoajan (kokoaja.h) ja vastaanottimen puskurin
+ * vapaasta tilasta. Lähetin ei kasaa ryhmää, joka ei mahdu ikkunaan.
+ * Ikkuna 0 tarkoittaa, että vastaanotin on kiireinen (esimerkiksi tulostaa
+ * valmista kuvaa), ja kun se vapautuu, se lähettää saman kuittauksen
+ * uudelleen avatulla ikkunalla (ikkunapäivitys).
+ *
+ * Kuittaus voi kulkea vastakkaiseen suuntaan lähetettävän paketin perässä:
+ * jos paketin koko on HEADER_SIZE + message[1] + ACK_SIZE, sen viimeiset
+ * ACK_SIZE byteä ovat kuittaus. Vastakkaiseen suuntaan ei kulje dataa,
+ * vain siirron lopun tilapaketti, joten vastaanotin lähettää kuittauksen
+ * heti, ellei tilapaketti lähde saman paketin käsittelyssä. Silloin
+ * ikkunapäivitys liitetään tilapakettiin. Uudempi kuittaus korvaa
+ * odottavan, koska kuittaukset ovat kumulatiivisia.
+ *
+ * Yleislähetyksessä (osoitteeseen ASK_TRANSMITTER_BROADCAST_ADDRESS)
+ * mitään ei kuitata ja headerin kentät ovat:
+ *
+ * 	message[1]		symbolin koko (tietopaketissa tietojen koko)
+ * 	message[2..3]	symbolin järjestysnumero ESN (tietopaketissa 0)
+ * 	message[4]		siirron tunniste, vaihtuu kun lähetettävä data vaihtuu
+ * 	message[5]		symbolien määrä K - 1
+ *
+ * Monilähetyksessä (osoitteeseen RYHMAOSOITE, monilahetys.h) mitään ei
+ * kuitata, vaan vastaanottimet pyytävät puuttuvat palat NACKilla.
+ * Headerin kentät ovat:
+ *
+ * 	message[0]		tietopaketissa tietopaketin lippu, muuten 0
+ * 	message[2..3]	palan numero (tietopaketissa kierroksen numero)
+ * 	message[4]		siirron tunniste, vaihtuu jokaisessa siirrossa
+ * 	message[5]		palojen määrä K - 1
+ *
+ * Tietopaketti lähetetään jokaisen kierroksen lopuksi. NACK lähetetään
+ * ryhmäosoitteeseen, jotta muut vastaanottimet kuulevat sen
+ * (NACK_KOKO(n) byteä):
+ *
+ * 	nack[0]			NACK_TUNNISTE
+ * 	nack[1]			siirron tunniste
+ * 	nack[2 + 4i..]	alueen i ensimmäinen pala ja palojen määrä
+ * 					(16-bittisiä, little endian), enintään NACK_MAX_ALUEITA aluetta
+*/
+#define HEADER_SIZE 6
+#define HEADER_LAST_FLAG (1 << 6)
+#define HEADER_INFO_FLAG (1 << 7)
+#define HEADER_PARITY_FLAG (1 << 5)
+#define HEADER_PARITY_COUNT_MASK 0x07
+#define HEADER_ACK_REQUEST_FLAG (1 << 3)
+#define HEADER_FOUNTAIN_FLAG (1 << 4)
+
+#define ACK_SIZE 6
+#define ACK_TUNNISTE 0xA0
+#define ACK_INFO_FLAG 0x01
+
+#define NACK_TUNNISTE 0xA2
+#define NACK_MAX_ALUEITA 4
+#define NACK_KOKO(alueita) (2 + 4 * (alueita))
+
+// Monilähetyksen ryhmäosoite, jonka ask-vastaanotin ottaa vastaan
+// rx_group_address -osoitteena
+#define RYHMAOSOITE 0x80
+
+// Suurin viesti, joka mahtuu vastaanottimen rengaspuskuriin:
+// puskurissa on tilaa ASK_RECEIVER_BUFFER_SIZE - 1 bytelle ja paketin
+// pituus, osoitteet, id, liput ja CRC vievät siitä 7 byteä.
+// Puskurin koko asetetaan mbed_app.json:ssa kaikille käännösyksiköille
+// (256: viesti on ASK_RECEIVER_MAXIMUM_MESSAGE_SIZE ja pala 242 byteä),
+// kirjaston oletuksella 64 pala ei voisi kasvaa 50 bytestä.
+#define ASK_PACKET_OVERHEAD 7
+
+// Lähettimien ja vastaanottimien bittinopeus (bit/s)
+#define BITTINOPEUS 1000
+#if (ASK_RECEIVER_BUFFER_SIZE - 1 - ASK_PACKET_OVERHEAD) < ASK_RECEIVER_MAXIMUM_MESSAGE_SIZE
+#define MAX_MESSAGE_SIZE (ASK_RECEIVER_BUFFER_SIZE - 1 - ASK_PACKET_OVERHEAD)
+#else
+#define MAX_MESSAGE_SIZE ASK_RECEIVER_MAXIMUM_MESSAGE_SIZE
+#endif
+
+#define MAX_PACKET_DATA_SIZE (MAX_MESSAGE_SIZE - HEADER_SIZE)
+#define MIN_PACKET_DATA_SIZE 8
+
+inline void kirjoitaU16(int8_t* kohde, uint16_t arvo)
+{
+	kohde[0] = (int8_t)(arvo & 0xFF);
+	kohde[1] = (int8_t)(arvo >> 8);
+}
+
+inline uint16_t lueU16(const uint8_t* lahde)
+{
+	return (uint16_t)lahde[0] | ((uint16_t)lahde[1] << 8);
+}
+
+/********************************************************
+ * Tietopaketti lähetetään ennen kuvan ensimmäistä pakettia.
+ * Sen dataosiossa on kuvan koko, CRC-32 -tarkiste (ask_CRC32.h),
+ * pakkausmenetelmä (pakkaus.h) ja siirrettävän datan koko.
+ * Kuvan koko ja tarkiste koskevat purettua kuvaa, datapakettien
+ * alkukohdat ja koot pakattua dataa. 32-bittiset luvut ovat little endian:
+ *
+ * 	data[0..3]	kuvan koko byteinä
+ * 	data[4..7]	koko kuvan CRC-32
+ * 	data[8]		pakkausmenetelmä
+ * 	data[9..12]	siirrettävän (pakatun) datan koko byteinä
+*/
+#define INFO_DATA_SIZE 13
+
+/********************************************************
+ * Tilapaketti lähetetään vastaanottimelta lähettimelle, kun siirto on
+ * käsitelty. Headerissa on tietopaketin lippu ja message[4] on seuraavan
+ * odotetun paketin järjestysnumero, muut kentät ovat 0:
+ *
+ * 	data[0]		1, jos kuva on tarkistettu ja kunnossa, muuten 0
+ * 	data[1..4]	vastaanotetun (puretun) kuvan koko byteinä
+*/
+#define TILA_DATA_SIZE 5
+
+// Kuittaus paketista: erillinen kuittaus tai paketin perässä oleva
+// kuittaus, 0 jos paketissa ei ole kuittausta
+inline const uint8_t* kuittausPaketissa(const uint8_t* paketti, int koko)
+{
+	const uint8_t* kuittaus = 0;
+	if (koko == ACK_SIZE)
+		kuittaus = paketti;
+	else if (koko > HEADER_SIZE && koko == HEADER_SIZE + paketti[1] + ACK_SIZE)
+		kuittaus = &paketti[koko - ACK_SIZE];
+	if (kuittaus && (kuittaus[0] & ~ACK_INFO_FLAG) != ACK_TUNNISTE)
+		kuittaus = 0;
+	return kuittaus;
+}
+
+inline void kirjoitaU32(int8_t* kohde, uint32_t arvo)
+{
+	for (int i = 0; i < 4; i++)
+		kohde[i] = (int8_t)(arvo >> (8 * i));
+}
+
+inline uint32_t lueU32(const uint8_t* lahde)
+{
+	return (uint32_t)lahde[0] | ((uint32_t)lahde[1] << 8) | ((uint32_t)lahde[2] << 16) | ((uint32_t)lahde[3] << 24);
+}
+
+#endif
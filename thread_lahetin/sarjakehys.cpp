@@ -0,0 +1,148 @@
+#include "sarjakehys.h"
+#include "ask_CRC32.h"
+
+CobsKooderi::CobsKooderi()
+{
+	_ulos = 0;
+	_konteksti = 0;
+	_koko = 0;
+}
+
+void CobsKooderi::aloita(Ulos ulos, void* konteksti)
+{
+	_ulos = ulos;
+	_konteksti = konteksti;
+	_koko = 0;
+	_ulos(0, _konteksti);
+}
+
+void CobsKooderi::kirjoitaLohko()
+{
+	_ulos((uint8_t)(_koko + 1), _konteksti);
+	for (int i = 0; i < _koko; i++)
+		_ulos(_lohko[i], _konteksti);
+	_koko = 0;
+}
+
+void CobsKooderi::lisaa(uint8_t tavu)
+{
+	// Nolla päättää lohkon (koodibyte kertoo sen paikan), täysi lohko
+	// kirjoitetaan koodilla 0xFF ilman nollaa
+	if (!tavu) {
+		kirjoitaLohko();
+		return;
+	}
+	_lohko[_koko++] = tavu;
+	if (_koko == 254)
+		kirjoitaLohko();
+}
+
+void CobsKooderi::lisaa(const uint8_t* data, int koko)
+{
+	for (int i = 0; i < koko; i++)
+		lisaa(data[i]);
+}
+
+void CobsKooderi::lopeta()
+{
+	kirjoitaLohko();
+	_ulos(0, _konteksti);
+}
+
+static void lisaaU32(CobsKooderi* kooderi, uint32_t* crc, uint32_t arvo)
+{
+	for (int i = 0; i < 4; i++) {
+		uint8_t tavu = (uint8_t)(arvo >> (8 * i));
+		if (crc)
+			*crc = CRC32::update(*crc, tavu);
+		kooderi->lisaa(tavu);
+	}
+}
+
+void kehystaKuva(const uint8_t* kuva, uint32_t pituus, uint8_t tila, CobsKooderi::Ulos ulos, void* konteksti)
+{
+	CobsKooderi kooderi;
+	uint8_t otsikko[2] = { SARJAKEHYS_TUNNISTE, tila };
+	uint32_t crc = CRC32::update(CRC32::begin(), otsikko, sizeof(otsikko));
+	kooderi.aloita(ulos, konteksti);
+	kooderi.lisaa(otsikko, sizeof(otsikko));
+	lisaaU32(&kooderi, &crc, pituus);
+	crc = CRC32::update(crc, kuva, pituus);
+	kooderi.lisaa(kuva, (int)pituus);
+	lisaaU32(&kooderi, 0, CRC32::complete(crc));
+	kooderi.lopeta();
+}
+
+void kehystaJaljitys(const uint32_t* sanat, int sanoja, CobsKooderi::Ulos ulos, void* konteksti)
+{
+	CobsKooderi kooderi;
+	uint8_t otsikko[3] = { SARJAKEHYS_JALJITYS, (uint8_t)sanat[0], (uint8_t)(sanat[0] >> 8) };
+	uint32_t crc = CRC32::update(CRC32::begin(), otsikko, sizeof(otsikko));
+	kooderi.aloita(ulos, konteksti);
+	kooderi.lisaa(otsikko, sizeof(otsikko));
+	for (int i = 1; i < sanoja; i++)
+		lisaaU32(&kooderi, &crc, sanat[i]);
+	lisaaU32(&kooderi, 0, CRC32::complete(crc));
+	kooderi.lopeta();
+}
+
+int cobsPura(const uint8_t* lahde, int koko, uint8_t* kohde, int kohteen_koko)
+{
+	int purettu = 0;
+	int i = 0;
+	while (i < koko) {
+		int koodi = lahde[i++];
+		if (!koodi || i + koodi - 1 > koko || purettu + koodi - 1 > kohteen_koko)
+			return -1;
+		for (int j = 1; j < koodi; j++) {
+			if (!lahde[i])
+				return -1;
+			kohde[purettu++] = lahde[i++];
+		}
+		// Lohkon perään kuuluu nolla, paitsi täyden ja viimeisen lohkon
+		if (koodi != 0xFF && i < koko) {
+			if (purettu == kohteen_koko)
+				return -1;
+			kohde[purettu++] = 0;
+		}
+	}
+	return purettu;
+}
+
+// protokolla.h tuo mukanaan mbed.h:n, joten isäntäkoneen purkajaa varten oma lukija
+static uint32_t lueKehysU32(const uint8_t* data)
+{
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static bool tarkistaKehys(const uint8_t* kehys, int koko, uint8_t tunniste, int vahintaan)
+{
+	return koko >= vahintaan && kehys[0] == tunniste &&
+		CRC32::compute(kehys, koko - 4) == lueKehysU32(&kehys[koko - 4]);
+}
+
+bool lueKuvaKehys(const uint8_t* kehys, int koko, const uint8_t** kuva, uint32_t* pituus, uint8_t* tila)
+{
+	if (!tarkistaKehys(kehys, koko, SARJAKEHYS_TUNNISTE, SARJAKEHYS_LISA))
+		return false;
+	uint32_t kuvan_pituus = lueKehysU32(&kehys[2]);
+	if (kuvan_pituus != (uint32_t)(koko - SARJAKEHYS_LISA))
+		return false;
+	*kuva = &kehys[SARJAKEHYS_OTSIKKO];
+	*pituus = kuvan_pituus;
+	*tila = kehys[1];
+	return true;
+}
+
+int lueJaljitysKehys(const uint8_t* kehys, int koko, uint32_t* sanat, int sanoja_enintaan)
+{
+	if (!tarkistaKehys(kehys, koko, SARJAKEHYS_JALJITYS, 3 + 4) || (koko - 3 - 4) % 4)
+		return -1;
+	int sanoja = 1 + (koko - 3 - 4) / 4;
+	if (sanoja > sanoja_enintaan)
+		return -1;
+	sanat[0] = (uint32_t)kehys[1] | ((uint32_t)kehys[2] << 8);
+	for (int i = 1; i < sanoja; i++)
+		sanat[i] = lueKehysU32(&kehys[3 + 4 * (i - 1)]);
+	return sanoja;
+}
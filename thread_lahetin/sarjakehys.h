@@ -0,0 +1,92 @@
+/*
+* Kuvan ja jäljitystietueiden tulostus sarjaporttiin binäärisinä COBS-kehyksinä
+*
+* Tekstinä ("%i ") jokainen byte vie sarjaportissa 2..5 merkkiä, joten
+* kuvan tulostus kesti kauemmin kuin radiosiirto. Kehyksessä byte vie
+* vähän yli yhden merkin, ja isäntäkoneen purkaja (host/sarjadekooderi.cpp)
+* erottaa kehykset muun tulosteen seasta, kirjoittaa kuvan tiedostoon ja
+* muotoilee jäljitystietueet riveiksi.
+*
+* COBS (Consistent Overhead Byte Stuffing) poistaa datasta nollat, joten
+* nolla erottaa kehykset toisistaan: kehyksen edessä ja perässä on 0x00.
+* Tekstitulosteessa ei ole nollia, joten se jää kehysten väliin omiksi
+* lohkoikseen, jotka purkaja tulostaa sellaisenaan. Koodattu lohko on
+* koodibyte c ja c-1 databyteä, joiden perään kuuluu nolla, ellei c ole
+* 0xFF tai lohko ole kehyksen viimeinen. Lisäys on enintään 1 byte 254
+* databyteä kohti.
+*
+* Kehyksen sisältö ennen koodausta on tunniste, sisältö ja CRC-32
+* tunnisteesta sisällön loppuun. Luvut vähiten merkitsevä byte ensin.
+*
+* Kuva:
+* 	tunniste (1)	SARJAKEHYS_TUNNISTE
+* 	tila (1)		SARJAKEHYS_KUNNOSSA tai SARJAKEHYS_VIRHEELLINEN
+* 	pituus (4)		kuvan pituus
+* 	kuva (pituus)
+* 	CRC-32 (4)
+*
+* Jäljitystietue (jaljitys.h):
+* 	tunniste (1)	SARJAKEHYS_JALJITYS
+* 	viesti (2)		JaljitysId
+* 	argumentit (4 kukin), määrä selviää kehyksen pituudesta
+* 	CRC-32 (4)
+*/
+
+#ifndef SARJAKEHYS_H
+#define SARJAKEHYS_H
+
+#include <stdint.h>
+
+#define SARJAKEHYS_TUNNISTE 0xC5
+#define SARJAKEHYS_JALJITYS 0xC6
+#define SARJAKEHYS_KUNNOSSA 0x00		// CRC-32 ja koko täsmäsivät tietopakettiin
+#define SARJAKEHYS_VIRHEELLINEN 0x01	// kuva on vajaa tai väärä
+#define SARJAKEHYS_OTSIKKO 6
+#define SARJAKEHYS_LISA (SARJAKEHYS_OTSIKKO + 4)
+
+class CobsKooderi
+{
+public:
+	// Koodattu data annetaan byte kerrallaan tälle funktiolle
+	typedef void (*Ulos)(uint8_t tavu, void* konteksti);
+
+	CobsKooderi();
+
+	// Uusi kehys, kirjoittaa erottimen
+	void aloita(Ulos ulos, void* konteksti);
+
+	void lisaa(uint8_t tavu);
+	void lisaa(const uint8_t* data, int koko);
+
+	// Kirjoittaa viimeisen lohkon ja erottimen
+	void lopeta();
+
+private:
+	void kirjoitaLohko();
+
+	Ulos _ulos;
+	void* _konteksti;
+	uint8_t _lohko[254];
+	int _koko;					// lohkossa olevat databytet
+};
+
+// Kirjoittaa kuvan kehyksenä (koodattuna ja erottimineen)
+void kehystaKuva(const uint8_t* kuva, uint32_t pituus, uint8_t tila, CobsKooderi::Ulos ulos, void* konteksti);
+
+// Kirjoittaa jäljitystietueen kehyksenä, sanat[0] on viestin numero
+void kehystaJaljitys(const uint32_t* sanat, int sanoja, CobsKooderi::Ulos ulos, void* konteksti);
+
+// Puretaan erottimien välinen COBS-lohko kohteeseen, palauttaa puretun
+// koon tai -1, jos lohko ei ole kelvollinen tai ei mahdu kohteeseen
+int cobsPura(const uint8_t* lahde, int koko, uint8_t* kohde, int kohteen_koko);
+
+// Tarkistetaan purettu kehys. Palauttaa false, jos tunniste, pituus tai
+// CRC-32 ei täsmää, muuten kuva, pituus ja tila asetetaan.
+bool lueKuvaKehys(const uint8_t* kehys, int koko, const uint8_t** kuva, uint32_t* pituus, uint8_t* tila);
+
+// Tarkistetaan purettu jäljityskehys ja luetaan sanat (viestin numero ja
+// argumentit). Palauttaa sanojen määrän tai -1, jos kehys ei ole
+// kelvollinen tai sanoja on enemmän kuin sanoja_enintaan.
+int lueJaljitysKehys(const uint8_t* kehys, int koko, uint32_t* sanat, int sanoja_enintaan);
+
+#endif
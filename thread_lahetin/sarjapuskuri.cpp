@@ -0,0 +1,96 @@
+#include "sarjapuskuri.h"
+#include <string.h>
+
+SarjaPuskuri::SarjaPuskuri(RawSerial* portti)
+{
+	_portti = portti;
+	_kirjoitus = 0;
+	_luku = 0;
+	_lahettaa = false;
+	_suurin_kaytto = 0;
+	_taynna = 0;
+}
+
+int SarjaPuskuri::kirjoita(const void* data, int koko)
+{
+	_kirjoittajat.lock();
+	uint32_t kirjoitus = _kirjoitus;
+	int vapaata = SARJAPUSKURI_KOKO - (int)(kirjoitus - _luku);
+	if (koko > vapaata) {
+		koko = vapaata;
+		_taynna++;
+	}
+
+	// Renkaan lopun yli menevä osa kopioidaan alkuun
+	uint32_t kohta = kirjoitus & (SARJAPUSKURI_KOKO - 1);
+	int ensin = SARJAPUSKURI_KOKO - (int)kohta;
+	if (ensin > koko)
+		ensin = koko;
+	memcpy(&_puskuri[kohta], data, ensin);
+	memcpy(_puskuri, (const uint8_t*)data + ensin, koko - ensin);
+
+	// Data on kirjoitettu ennen kuin keskeytys näkee sen
+	__DMB();
+	_kirjoitus = kirjoitus + koko;
+	int kaytto = (int)(_kirjoitus - _luku);
+	if (kaytto > _suurin_kaytto)
+		_suurin_kaytto = kaytto;
+
+	// Keskeytys sammuttaa itsensä tyhjässä renkaassa, käynnistetään se
+	// uudelleen. Lähetysrekisteri on tyhjä, joten keskeytys tulee heti.
+	core_util_critical_section_enter();
+	if (koko && !_lahettaa) {
+		_lahettaa = true;
+		_portti->attach(callback(this, &SarjaPuskuri::lahetysKeskeytys), RawSerial::TxIrq);
+	}
+	core_util_critical_section_exit();
+	_kirjoittajat.unlock();
+	return koko;
+}
+
+void SarjaPuskuri::kirjoitaKaikki(const void* data, int koko)
+{
+	// Mutex on rekursiivinen, joten kirjoita voi varata sen uudelleen
+	const uint8_t* lahde = (const uint8_t*)data;
+	_kirjoittajat.lock();
+	for (;;) {
+		int kirjoitettu = kirjoita(lahde, koko);
+		lahde += kirjoitettu;
+		koko -= kirjoitettu;
+		if (!koko)
+			break;
+		ThisThread::sleep_for(1);
+	}
+	_kirjoittajat.unlock();
+}
+
+void SarjaPuskuri::lahetysKeskeytys()
+{
+	uint32_t luku = _luku;
+	while (luku != _kirjoitus && _portti->writeable()) {
+		_portti->putc(_puskuri[luku & (SARJAPUSKURI_KOKO - 1)]);
+		luku++;
+	}
+	_luku = luku;
+
+	// Tyhjässä renkaassa keskeytys tulisi jatkuvasti, sammutetaan se
+	if (luku == _kirjoitus) {
+		_portti->attach(Callback<void()>(), RawSerial::TxIrq);
+		_lahettaa = false;
+	}
+}
+
+int SarjaPuskuri::vapaa()
+{
+	return SARJAPUSKURI_KOKO - (int)(_kirjoitus - _luku);
+}
+
+int SarjaPuskuri::suurinKaytto()
+{
+	return _suurin_kaytto;
+}
+
+uint32_t SarjaPuskuri::taynna()
+{
+	return _taynna;
+}
@@ -0,0 +1,70 @@
+/*
+* Keskeytysohjattu lähetyspuskuri sarjaportille
+*
+* Kirjoittaja kopioi datan renkaaseen ja palaa heti, UARTin
+* lähetyskeskeytys siirtää renkaasta byten kerrallaan lähetysrekisteriin.
+* Kirjoittava thread ei siten odota sarjaporttia (9600 baudilla noin
+* 1 ms merkiltä), eikä EventThread pyöri korkeammalla prioriteetilla
+* odottamassa lähetysrekisteriä muiden threadien kustannuksella.
+*
+* Kirjoittajia voi olla monta: kirjoitus tehdään mutexin suojassa
+* kokonaisena, joten eri threadien kirjoitukset eivät sekoitu keskenään.
+* Renkaan kokoa suurempi kirjoitus (kirjoitaKaikki) pitää mutexin koko
+* kirjoituksen ajan, joten muut kirjoittajat odottavat sen loppuun.
+* Keskeytys on ainoa lukija. Laskurit kasvavat ympäri pyörähtäen, paikka
+* on laskuri % SARJAPUSKURI_KOKO.
+*
+* Lähetyskeskeytys on päällä vain, kun renkaassa on lähetettävää:
+* kirjoitus käynnistää sen, ja keskeytys sammuttaa itsensä, kun rengas
+* tyhjenee. Keskeytyksessä ei voi käyttää Serialia (mutex), siksi
+* portti on RawSerial.
+*/
+
+#ifndef SARJAPUSKURI_H
+#define SARJAPUSKURI_H
+
+#include "mbed.h"
+#include <stdint.h>
+
+#define SARJAPUSKURI_KOKO 1024			// 2:n potenssi
+
+#if (SARJAPUSKURI_KOKO & (SARJAPUSKURI_KOKO - 1))
+#error SARJAPUSKURI_KOKO pitää olla 2:n potenssi
+#endif
+
+class SarjaPuskuri
+{
+public:
+	SarjaPuskuri(RawSerial* portti);
+
+	// Kopioidaan renkaaseen niin paljon kuin mahtuu, palauttaa kopioitujen
+	// bytejen määrän. Ei odota eikä kutsu ole sallittu keskeytyksestä.
+	int kirjoita(const void* data, int koko);
+
+	// Kopioidaan kaikki, täydessä renkaassa odotetaan tilaa nukkumalla
+	// (ei pyöritä prosessoria lähetyksen ajan). Mutex on varattuna koko
+	// ajan, joten muiden kirjoitukset eivät mene tämän väliin.
+	void kirjoitaKaikki(const void* data, int koko);
+
+	// Renkaan vapaa tila (byteä)
+	int vapaa();
+
+	// Renkaan suurin käyttö (byteä) ja täyden renkaan takia kesken jääneet
+	// kirjoitukset, puskurin koon mitoittamiseen
+	int suurinKaytto();
+	uint32_t taynna();
+
+private:
+	void lahetysKeskeytys();
+
+	RawSerial* _portti;
+	Mutex _kirjoittajat;
+	uint8_t _puskuri[SARJAPUSKURI_KOKO];
+	volatile uint32_t _kirjoitus;	// vain kirjoittajat (mutexin suojassa)
+	volatile uint32_t _luku;		// vain keskeytys
+	volatile bool _lahettaa;		// lähetyskeskeytys on päällä
+	int _suurin_kaytto;
+	uint32_t _taynna;
+};
+
+#endif
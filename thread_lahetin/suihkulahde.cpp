@@ -0,0 +1,196 @@
+#include "suihkulahde.h"
+#include <math.h>
+
+// Robust soliton -jakauman parametrit
+#define LT_C 0.1f
+#define LT_DELTA 0.5f
+
+int ltSymboleita(int koko, int symbolin_koko)
+{
+	return (koko + symbolin_koko - 1) / symbolin_koko;
+}
+
+static uint32_t satunnainen(uint32_t* tila)
+{
+	// xorshift32
+	uint32_t x = *tila;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*tila = x;
+	return x;
+}
+
+static float solitonPaino(int d, int k, float r, int raja)
+{
+	// Ideaalinen soliton ...
+	float paino = d == 1 ? 1.0f / k : 1.0f / ((float)d * (d - 1));
+
+	// ... ja robust-osa, joka lisää pieniasteisia ja asteen k / R symboleita
+	if (d < raja)
+		paino += r / ((float)d * k);
+	else if (d == raja && r > LT_DELTA)
+		paino += r * logf(r / LT_DELTA) / k;
+	return paino;
+}
+
+static int ltAste(uint32_t* tila, int k)
+{
+	if (k <= 1)
+		return 1;
+
+	float r = LT_C * logf(k / LT_DELTA) * sqrtf((float)k);
+	int raja = (int)(k / r);
+	if (raja < 1)
+		raja = 1;
+	if (raja > k)
+		raja = k;
+
+	float summa = 0;
+	for (int d = 1; d <= k; d++)
+		summa += solitonPaino(d, k, r, raja);
+
+	float arvo = (satunnainen(tila) >> 8) * (summa / 16777216.0f);
+	float kertyma = 0;
+	for (int d = 1; d <= k; d++) {
+		kertyma += solitonPaino(d, k, r, raja);
+		if (arvo < kertyma)
+			return d;
+	}
+	return k;
+}
+
+uint64_t ltNaapurit(uint16_t esn, int k)
+{
+	// Tila ei saa olla nolla
+	uint32_t tila = ((uint32_t)esn + 1) * 0x9E3779B9u;
+	satunnainen(&tila);
+
+	int aste = ltAste(&tila, k);
+	uint64_t maski = 0;
+	for (int valittu = 0; valittu < aste; ) {
+		uint64_t bitti = (uint64_t)1 << (satunnainen(&tila) % k);
+		if (!(maski & bitti)) {
+			maski |= bitti;
+			valittu++;
+		}
+	}
+	return maski;
+}
+
+int ltKoodaa(int8_t* kohde, KuvaLahde* data, int symbolin_koko, uint16_t esn)
+{
+	int k = ltSymboleita(data->koko(), symbolin_koko);
+	uint64_t maski = ltNaapurit(esn, k);
+
+	for (int n = 0; n < symbolin_koko; n++)
+		kohde[n] = 0;
+	for (int i = 0; i < k; i++) {
+		if (!(maski & ((uint64_t)1 << i)))
+			continue;
+		uint8_t symboli[LT_MAX_SYMBOLIN_KOKO];
+		int luettu = data->lue((uint32_t)i * symbolin_koko, symboli, symbolin_koko);
+		if (luettu < 0)
+			return -1;
+		for (int n = 0; n < luettu; n++)
+			kohde[n] ^= symboli[n];
+	}
+	return symbolin_koko;
+}
+
+LtPurkaja::LtPurkaja()
+{
+	aloita(0, 0);
+}
+
+void LtPurkaja::aloita(int k, int symbolin_koko)
+{
+	_k = k > LT_MAX_K ? LT_MAX_K : k;
+	_symbolin_koko = symbolin_koko > LT_MAX_SYMBOLIN_KOKO ? LT_MAX_SYMBOLIN_KOKO : symbolin_koko;
+	_saatuja = 0;
+	_riippumattomia = 0;
+	_valmis = false;
+	for (int i = 0; i < LT_MAX_K; i++)
+		_maskit[i] = 0;
+}
+
+bool LtPurkaja::lisaa(uint16_t esn, const uint8_t* symboli)
+{
+	if (_valmis || !_k)
+		return _valmis;
+	_saatuja++;
+
+	uint64_t maski = ltNaapurit(esn, _k);
+	uint8_t rivi[LT_MAX_SYMBOLIN_KOKO];
+	for (int n = 0; n < _symbolin_koko; n++)
+		rivi[n] = symboli[n];
+
+	// Poistetaan symbolista jo tallessa olevat rivit alimmasta bitistä
+	// alkaen. Rivin alin bitti on sen oma indeksi, joten XOR poistaa sen
+	// eikä lisää alempia bittejä.
+	for (int i = 0; i < _k; i++) {
+		uint64_t bitti = (uint64_t)1 << i;
+		if (!(maski & bitti))
+			continue;
+		if (!_maskit[i]) {
+			_maskit[i] = maski;
+			for (int n = 0; n < _symbolin_koko; n++)
+				_rivit[i][n] = rivi[n];
+			if (++_riippumattomia == _k)
+				ratkaise();
+			return _valmis;
+		}
+		maski ^= _maskit[i];
+		for (int n = 0; n < _symbolin_koko; n++)
+			rivi[n] ^= _rivit[i][n];
+	}
+
+	// Symboli oli riippuvainen jo saaduista, siitä ei ollut hyötyä
+	return false;
+}
+
+void LtPurkaja::ratkaise()
+{
+	// Takaisinsijoitus: ylin rivi on jo datan symboli, alemmista
+	// poistetaan niiden ylemmät bitit
+	for (int i = _k - 1; i >= 0; i--) {
+		for (int j = i + 1; j < _k; j++) {
+			if (!(_maskit[i] & ((uint64_t)1 << j)))
+				continue;
+			for (int n = 0; n < _symbolin_koko; n++)
+				_rivit[i][n] ^= _rivit[j][n];
+		}
+		_maskit[i] = (uint64_t)1 << i;
+	}
+	_valmis = true;
+}
+
+bool LtPurkaja::valmis()
+{
+	return _valmis;
+}
+
+int LtPurkaja::k()
+{
+	return _k;
+}
+
+int LtPurkaja::symbolinKoko()
+{
+	return _symbolin_koko;
+}
+
+int LtPurkaja::saatuja()
+{
+	return _saatuja;
+}
+
+int LtPurkaja::riippumattomia()
+{
+	return _riippumattomia;
+}
+
+const uint8_t* LtPurkaja::symboli(int i)
+{
+	return _rivit[i];
+}
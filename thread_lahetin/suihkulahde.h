@@ -0,0 +1,77 @@
+/*
+* Suihkulähdekoodattu (LT-koodi) yleislähetys ilman kuittauksia
+*
+* Lähetettävä data jaetaan K symboliin. Jokainen lähetetty symboli on
+* XOR satunnaisesti valituista datan symboleista, joiden määrä (aste)
+* arvotaan robust soliton -jakaumasta. Valinnat määrää symbolin
+* järjestysnumero (ESN), joten vastaanotin laskee ne samoin eikä niitä
+* tarvitse lähettää. Symboleita voidaan lähettää rajattomasti, ja
+* vastaanotin saa datan purettua, kun se on kerännyt hieman yli K
+* symbolia riippumatta siitä, mitkä symbolit siltä jäivät saamatta.
+*
+* Purkaja pitää saadut symbolit porrasmuodossa (Gaussin eliminointi
+* sitä mukaa kuin symboleita tulee), jolloin jokainen lineaarisesti
+* riippumaton symboli vie purkua eteenpäin.
+*/
+
+#ifndef SUIHKULAHDE_H
+#define SUIHKULAHDE_H
+
+#include <stdint.h>
+#include "protokolla.h"
+#include "kuvalahde.h"
+
+// Symbolien valinnat pidetään 64-bittisessä maskissa
+#define LT_MAX_K 64
+#define LT_MAX_SYMBOLIN_KOKO MAX_PACKET_DATA_SIZE
+
+// Montako symbolia tarvitaan koko datalle
+int ltSymboleita(int koko, int symbolin_koko);
+
+// Symbolin esn datan symbolit (bitti i = symboli i)
+uint64_t ltNaapurit(uint16_t esn, int k);
+
+// Lähetin: koodaa symbolin esn kohteeseen lähteen datasta, palauttaa
+// symbolin koon tai -1, jos lähdettä ei voi lukea.
+// Viimeinen datan symboli täytetään nollilla.
+int ltKoodaa(int8_t* kohde, KuvaLahde* data, int symbolin_koko, uint16_t esn);
+
+/*
+* Vastaanotin: kerää symbolit ja purkaa datan
+*/
+class LtPurkaja
+{
+public:
+	LtPurkaja();
+
+	// Uusi siirto, k = 0 tarkoittaa, ettei siirtoa ole aloitettu
+	void aloita(int k, int symbolin_koko);
+
+	// Lisätään vastaanotettu symboli, palauttaa true, kun data on purettu
+	bool lisaa(uint16_t esn, const uint8_t* symboli);
+
+	bool valmis();
+	int k();
+	int symbolinKoko();
+
+	// Saatujen symbolien määrä ja niistä riippumattomien määrä
+	int saatuja();
+	int riippumattomia();
+
+	// Puretun datan symboli i
+	const uint8_t* symboli(int i);
+
+private:
+	void ratkaise();
+
+	int _k;
+	int _symbolin_koko;
+	int _saatuja;
+	int _riippumattomia;
+	bool _valmis;
+	// Rivi i on symboli, jonka maskin alin bitti on i (tai puretun datan symboli i)
+	uint64_t _maskit[LT_MAX_K];
+	uint8_t _rivit[LT_MAX_K][LT_MAX_SYMBOLIN_KOKO];
+};
+
+#endif
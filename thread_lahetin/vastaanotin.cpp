@@ -6,13 +6,15 @@
 
     #include "ask_transmitter.h"
     ask_transmitter_t lahetin2;
-	char viesti2[]="2: ACKviesti";
+	uint8_t kuittaus2[6];		// kuittaus, ACK_SIZE (protokolla.h)
+	uint8_t tila2[6 + 5 + 6];	// tilapaketti ja sen perässä kuittaus
 	uint8_t receiver_transmitter_address = 0x02;
 	uint8_t receiver_target_receiver_address = 0x01;
 	
 	#include "ask_receiver.h"
 	ask_receiver_t vastaanotin2;
-	#define BUFFER_SIZE 60
+	#include "protokolla.h"
+	#define BUFFER_SIZE MAX_MESSAGE_SIZE
 	uint8_t buffer2[BUFFER_SIZE];
 	uint8_t receiver_receiver_address = 0x02;
 	uint8_t receiver_received_receiver_address = 0;
@@ -20,40 +22,438 @@
 	
 
 
-#define PACKET_DATA_SIZE 50
-#define HEADER_SIZE 2
-#define PACKET_SIZE PACKET_DATA_SIZE+HEADER_SIZE
+#include "ask_CRC32.h"
+#include "pakkaus.h"
+#include "fec.h"
+#include "suihkulahde.h"
+#include "kokoaja.h"
+#include "jpeg.h"
+#include "monilahetys.h"
+#include "jaljitys.h"
 
 uint16_t recv_offset = 0;	// data-taulukon iteraattori
 int8_t data[3000];			// taulukko vastaanotetulle datalle
 
-void luePaketti() {
+// Tietopaketissa saadut kuvan koko ja tarkiste sekä
+// pakkausmenetelmä ja siirrettävän (pakatun) datan koko
+bool tiedot_saatu = false;
+uint32_t kuvan_koko = 0;
+uint32_t kuvan_crc = 0;
+Pakkaus kuvan_pakkaus = PAKKAUS_EI;
+uint32_t siirron_koko = 0;
 
-	/* Tässä funktiossa kirjoitetaan vastaanotettu paketti data-taulukkoon*/
+// Siirron alusta järjestyksessä vastaanotettujen bytejen määrä
+uint32_t valmis_koko = 0;
 
-	if ( (buffer2[0] >> 6) == 0) {				// Tarkistetaan, onko viimeisen paketin bitti 1
-		recv_offset = buffer2[0]*50;			// recv_offset on iteraattori, paketin järj.luku*50
-		for (int j=0; j<buffer2[1]; j++) {		
-			data[recv_offset] = buffer2[j+2];	// buffer2[] on vastaanotettu puskuri,
-			recv_offset++;						// 2 ensimmäistä alkiota ovat header
-		}
+// Jo saatujen pakettien (kuittaus kadonnut) määrä siirron aikana
+unsigned int toistoja = 0;
+
+// Kuittaus liitetään lähettimelle menevään pakettiin (protokolla.h), jos
+// sellainen lähtee saman paketin käsittelyssä (tila_tulossa). Ainoa
+// tällainen paketti on siirron lopun tilapaketti, joten muuten kuittaus
+// lähtee heti. KUITTAUSVIIVE > 0 pitää kuittausta enintään niin monta
+// ms odottamassa muuta lähettimelle lähtevää dataa, mutta se pidentää
+// jokaisen ryhmän kiertoaikaa.
+#ifndef KUITTAUSVIIVE
+#define KUITTAUSVIIVE 0
+#endif
+Timer kuittausviive2;
+bool kuittaus_odottaa = false;
+bool tila_tulossa = false;
+unsigned int liitettyja = 0;		// paketteihin liitetyt kuittaukset
+
+// Viimeksi käsitellyn siirron tulos tilapakettiin
+bool siirto_kunnossa = false;
+uint32_t siirron_kuva = 0;
+
+// Puretun kuvan koko ja siitä laskettu (keskeneräinen) CRC-32
+uint32_t purettu_koko = 0;
+uint32_t purettu_crc = 0;
+bool kuva_virheellinen = false;
+Purkaja purkaja;
+
+// JPEG-kuvasta kerrotaan, kun otsikot ja scanit ovat perillä (jpeg.h)
+JpegSeuraaja jpeg_seuraaja;
+
+// Datapaketit kootaan ryhmiksi, joista kadonneet korjataan pariteetilla (fec.h)
+FecRyhma ryhma;
+
+// Paketit järjestykseen, data käsitellään heti kun se on yhtenäinen (kokoaja.h)
+Kokoaja kokoaja;
+void kirjoitaSiirto(uint32_t alku, const uint8_t* pala, int koko, void*);
+
+// Yleislähetyksen symbolit kerätään, kunnes kuva voidaan purkaa (suihkulahde.h)
+LtPurkaja lt;
+int lt_siirto = -1;				// siirron tunniste, -1 = ei siirtoa
+bool lt_kasitelty = false;		// siirron kuva on jo purettu ja tarkistettu
+
+// Monilähetyksen palat kerätään ja puuttuvat pyydetään NACKilla (monilahetys.h)
+MoniVastaanotto moni;
+bool moni_kasitelty = false;	// siirron kuva on jo purettu ja tarkistettu
+Timer monikello2;
+uint8_t nack2[NACK_KOKO(NACK_MAX_ALUEITA)];
+
+uint16_t vastaanottoIkkuna(bool kokoaja_tyhjenee) {
+
+	/* Montako byteä dataa lähetin voi lähettää: kokoajan vapaa tila,
+	   josta vähennetään vastaanottimen puskurissa vielä lukemattomat
+	   paketit. Valmiin ryhmän data annetaan kokoajalle kuittauksen
+	   jälkeen, jolloin koko ikkuna vapautuu (kokoaja_tyhjenee). */
+
+	int ikkuna = kokoaja_tyhjenee ? KOKOAJA_IKKUNA : kokoaja.vapaa();
+	ask_receiver_status_t tila;
+	vastaanotin2.status(&tila);
+	ikkuna -= ASK_RECEIVER_BUFFER_SIZE - 1 - (int)tila.buffer_free_space;
+	return ikkuna > 0 ? (uint16_t)ikkuna : 0;
+}
+
+void lahetaKuittaus();
+
+void kuittaa(bool tietopaketti, uint8_t kuitattu, uint16_t saadut, uint16_t ikkuna) {
+
+	/* Kumulatiivinen kuittaus, kesken olevan ryhmän saadut paketit
+	   ja vastaanottoikkuna. Kuittaus jää odottamaan lähetystä,
+	   uudempi korvaa vanhemman. */
+
+	kuittaus2[0] = ACK_TUNNISTE | (tietopaketti ? ACK_INFO_FLAG : 0);
+	kuittaus2[1] = kuitattu;
+	kuittaus2[2] = (uint8_t)(saadut & 0xFF);
+	kuittaus2[3] = (uint8_t)(saadut >> 8);
+	kuittaus2[4] = (uint8_t)(ikkuna & 0xFF);
+	kuittaus2[5] = (uint8_t)(ikkuna >> 8);
+	if (!kuittaus_odottaa) {
+		kuittausviive2.reset();
+		kuittausviive2.start();
+	}
+	kuittaus_odottaa = true;
+	if (KUITTAUSVIIVE == 0 && !tila_tulossa)
+		lahetaKuittaus();
+}
+
+void lahetaKuittaus() {
+
+	/* Odottava kuittaus lähetetään erillisenä pakettina */
+
+	if (!kuittaus_odottaa)
+		return;
+	while(!lahetin2.send(receiver_target_receiver_address,&kuittaus2, ACK_SIZE))
+	{
+		jaljita(J2_LAHETYS_EPAONNISTUI);
+	}
+	kuittaus_odottaa = false;
+}
+
+void lahetaTila() {
+
+	/* Käsitellyn siirron tulos lähettimelle, odottava kuittaus
+	   liitetään perään (protokolla.h) */
+
+	int koko = HEADER_SIZE + TILA_DATA_SIZE;
+	for (int i = 0; i < HEADER_SIZE; i++)
+		tila2[i] = 0;
+	tila2[0] = HEADER_INFO_FLAG;
+	tila2[1] = TILA_DATA_SIZE;
+	tila2[4] = ryhma.alku();
+	tila2[HEADER_SIZE] = siirto_kunnossa ? 1 : 0;
+	kirjoitaU32((int8_t *)&tila2[HEADER_SIZE + 1], siirron_kuva);
+	if (kuittaus_odottaa) {
+		for (int i = 0; i < ACK_SIZE; i++)
+			tila2[koko + i] = kuittaus2[i];
+		koko += ACK_SIZE;
+		kuittaus_odottaa = false;
+		liitettyja++;
 	}
-	else {										// Jos viimeisen paketin bitti == 1
-		recv_offset = (buffer2[0] - 64)*50;
-		for (int j=0; j<buffer2[1]; j++) {
-			data[recv_offset] = buffer2[j+2];
+	tila_tulossa = false;
+	while(!lahetin2.send(receiver_target_receiver_address,&tila2, koko))
+	{
+		jaljita(J2_LAHETYS_EPAONNISTUI);
+	}
+}
+
+void kuvaVirhe(JaljitysId syy) {
+	if (!kuva_virheellinen)
+		jaljita(syy);
+	kuva_virheellinen = true;
+}
+
+void kirjoitaKuvaan(uint8_t tavu, void*) {
+
+	/* Purkaja antaa puretun kuvan byte kerrallaan */
+
+	if (purettu_koko >= kuvan_koko) {
+		kuvaVirhe(J2_PURETTUA_LIIKAA);
+		return;
+	}
+	// data-taulukkoon mahtumaton loppu vain tarkistetaan
+	if (purettu_koko < sizeof(data))
+		data[purettu_koko] = tavu;
+	purettu_koko++;
+	purettu_crc = CRC32::update(purettu_crc, tavu);
+
+	// Esikatselun voi näyttää, kun otsikot ja ensimmäiset scanit on saatu
+	if (jpeg_seuraaja.lisaa(tavu)) {
+		if (jpeg_seuraaja.valmiitaScaneja() == 0)
+			jaljita(J2_ESIKATSELU_OTSIKOT, purettu_koko);
+		else
+			jaljita(J2_ESIKATSELU_SCAN, jpeg_seuraaja.valmiitaScaneja(), purettu_koko, kuvan_koko);
+	}
+}
+
+void lueTietopaketti(const uint8_t* paketti) {
+
+	/* Uuden kuvan tiedot, nollataan tarkistus ja purkaja */
+
+	kuvan_koko = lueU32(&paketti[HEADER_SIZE]);
+	kuvan_crc = lueU32(&paketti[HEADER_SIZE + 4]);
+	kuvan_pakkaus = (Pakkaus)paketti[HEADER_SIZE + 8];
+	siirron_koko = lueU32(&paketti[HEADER_SIZE + 9]);
+	tiedot_saatu = true;
+	valmis_koko = 0;
+	purettu_koko = 0;
+	purettu_crc = CRC32::begin();
+	kuva_virheellinen = false;
+	purkaja.aloita(kuvan_pakkaus, kirjoitaKuvaan, 0);
+	jpeg_seuraaja.aloita();
+	kokoaja.aloita(kirjoitaSiirto, 0);
+
+	if (kuvan_koko > sizeof(data))
+		jaljita(J2_EI_MAHDU_TAULUKKOON, sizeof(data));
+}
+
+void vastaanotaPala(uint32_t alku, const uint8_t* pala, int koko) {
+
+	/* Puretaan ja tarkistetaan dataa sitä mukaa kuin paloja tulee.
+	   Jo käsitelty pala (uudelleenlähetys) ei muuta mitään,
+	   väliin jäänyt pala huomataan heti. */
+
+	if (kuva_virheellinen)
+		return;
+
+	if (alku > valmis_koko) {
+		kuvaVirhe(J2_SIIRROSTA_PUUTTUU);
+	}
+	else if (alku + koko > valmis_koko) {
+		uint32_t jo_saatu = valmis_koko - alku;
+		if (!purkaja.pura(&pala[jo_saatu], koko - jo_saatu))
+			kuvaVirhe(J2_PAKATTU_VIRHEELLINEN);
+		valmis_koko = alku + koko;
+		if (valmis_koko > siirron_koko)
+			kuvaVirhe(J2_SIIRRETTYA_LIIKAA);
+	}
+}
+
+void kirjoitaSiirto(uint32_t alku, const uint8_t* pala, int koko, void*) {
+
+	/* Kokoaja antaa siirron datan järjestyksessä heti, kun se on yhtenäinen */
+
+	if (tiedot_saatu) {
+		// Data puretaan (tarvittaessa) suoraan data-taulukkoon
+		vastaanotaPala(alku, pala, koko);
+	}
+	else {
+		// Ilman tietopakettia data oletetaan pakkaamattomaksi
+		recv_offset = alku;			// recv_offset on iteraattori, alkaa palan alkukohdasta
+		for (int j=0; j<koko && recv_offset<sizeof(data); j++) {
+			data[recv_offset] = pala[j];
 			recv_offset++;
 		}
-		wait_us(1000000);			// Odotetaan sekunti, että datan tulostus tulee yhtenäisenä
-		pc.printf("2: viimeinen paketti vastaanotettu, data:\n\r");
-		// Tulostetaan koko data[]-taulukko
-		for (unsigned int k=0; k<(recv_offset-1); k++) {
-			pc.printf("%i ", data[k]);
+	}
+}
+
+bool tietopakettiSaatu(const uint8_t* paketti) {
+
+	/* Onko sama tietopaketti jo käsitelty (sen kuittaus on kadonnut) */
+
+	return tiedot_saatu && paketti[4] == ryhma.alku() &&
+		lueU32(&paketti[HEADER_SIZE]) == kuvan_koko && lueU32(&paketti[HEADER_SIZE + 4]) == kuvan_crc &&
+		lueU32(&paketti[HEADER_SIZE + 9]) == siirron_koko;
+}
+
+bool kuvaKunnossa() {
+
+	/* Viimeisen paketin jälkeen tarkistetaan koko ja CRC-32 */
+
+	if (!tiedot_saatu) {
+		jaljita(J2_EI_TIETOPAKETTIA);
+		return true;
+	}
+	if (kuva_virheellinen)
+		return false;
+	if (valmis_koko != siirron_koko || !purkaja.valmis() || purettu_koko != kuvan_koko) {
+		jaljita(J2_KUVA_VAJAA, purettu_koko, kuvan_koko);
+		return false;
+	}
+	if (CRC32::complete(purettu_crc) != kuvan_crc) {
+		jaljita(J2_CRC_VIRHE);
+		return false;
+	}
+	return true;
+}
+
+void kuvaValmis() {
+
+	/* Koko siirto on saatu, tarkistetaan ja tulostetaan kuva */
+
+	// Tulostus kestää, joten odottava kuittaus (suljettu ikkuna) lähtee ensin
+	lahetaKuittaus();
+
+	siirto_kunnossa = kuvaKunnossa();
+	siirron_kuva = purettu_koko;
+	if (siirto_kunnossa)
+		jaljita(J2_SIIRTO_KUNNOSSA);
+	else
+		jaljita(J2_SIIRTO_VIRHEELLINEN);
+	if (tiedot_saatu && kuvan_koko)
+		jaljita(J2_SIIRTO_TILASTO, valmis_koko, kuvan_koko, kuvan_pakkaus, 100 * valmis_koko / kuvan_koko, toistoja, liitettyja);
+	// Tulostetaan data[]-taulukosta purettu kuva, tai jos kuvan
+	// tietoja ei saatu, kaikki mitä on vastaanotettu
+	unsigned int tulostettava = tiedot_saatu ? purettu_koko : recv_offset;
+	if (tulostettava > sizeof(data))
+		tulostettava = sizeof(data);
+	printImage(data, tulostettava, siirto_kunnossa);
+	recv_offset = 0;		// Iteraattorin nollaus
+	toistoja = 0;
+	liitettyja = 0;
+	tiedot_saatu = false;
+	kokoaja.aloita(kirjoitaSiirto, 0);
+}
+
+void luePaketti(const uint8_t* paketti) {
+
+	/* Vastaanotettu datapaketti annetaan kokoajalle, joka kirjoittaa datan
+	   data-taulukkoon järjestyksessä (kirjoitaSiirto). Paketit voivat tulla
+	   missä järjestyksessä tahansa ja samakin paketti useaan kertaan. */
+
+	// Headerissa on alkukohdan alimmat 16 bittiä. Lähetin on enintään
+	// ryhmän verran järjestyksessä saadun datan edellä, joten koko
+	// alkukohta on lähin sellainen, jonka alimmat bitit täsmäävät.
+	uint32_t valmis = kokoaja.valmis();
+	int16_t ero = (int16_t)(lueU16(&paketti[2]) - (uint16_t)valmis);
+	if (ero < 0 && (uint32_t)-ero > valmis)
+		return;
+	uint32_t alku = valmis + ero;
+	if (kokoaja.lisaa(alku, &paketti[HEADER_SIZE], paketti[1], paketti[0] & HEADER_LAST_FLAG))
+		kuvaValmis();
+}
+
+void vastaanotaSuihku(const uint8_t* paketti, int koko) {
+
+	/* Yleislähetyksen paketit: tietopaketti toistuu symbolien välissä,
+	   kuva puretaan, kun sekä tiedot että tarpeeksi symboleita on saatu */
+
+	uint8_t siirto = paketti[4];
+	int k = paketti[5] + 1;
+	if (siirto != lt_siirto) {
+		// Uusi data, aloitetaan alusta
+		lt_siirto = siirto;
+		lt_kasitelty = false;
+		lt.aloita(0, 0);
+		tiedot_saatu = false;
+	}
+	if (lt_kasitelty)
+		return;
+
+	if (paketti[0] & HEADER_INFO_FLAG) {
+		if (!tiedot_saatu)
+			lueTietopaketti(paketti);
+	}
+	else {
+		if (!lt.k()) {
+			if (k > LT_MAX_K || paketti[1] > LT_MAX_SYMBOLIN_KOKO || koko < HEADER_SIZE + paketti[1]) {
+				jaljita(J2_VIRHEELLINEN_YLEISLAHETYS);
+				return;
+			}
+			lt.aloita(k, paketti[1]);
+		}
+		if (k != lt.k() || paketti[1] != lt.symbolinKoko() || koko < HEADER_SIZE + paketti[1])
+			return;
+		lt.lisaa(lueU16(&paketti[2]), &paketti[HEADER_SIZE]);
+	}
+
+	if (!lt.valmis() || !tiedot_saatu)
+		return;
+
+	jaljita(J2_YLEISLAHETYS_PURETTU, lt.saatuja(), lt.k());
+	int symbolin_koko = lt.symbolinKoko();
+	for (int i = 0; i < lt.k(); i++) {
+		int alku = i * symbolin_koko;
+		int pala = (int)siirron_koko - alku;
+		if (pala > symbolin_koko)
+			pala = symbolin_koko;
+		if (pala > 0)
+			vastaanotaPala(alku, lt.symboli(i), pala);
+	}
+	lt_kasitelty = true;
+	kuvaValmis();
+}
+
+void lahetaNack() {
+
+	/* Monilähetyksen NACK lähtee ryhmäosoitteeseen satunnaisen viiveen
+	   jälkeen, ellei toinen vastaanotin ole jo pyytänyt samoja paloja */
+
+	int koko = moni.nack(monikello2.read_ms(), nack2);
+	if (!koko)
+		return;
+	while(!lahetin2.send(RYHMAOSOITE,&nack2, koko))
+	{
+		jaljita(J2_LAHETYS_EPAONNISTUI);
+	}
+}
+
+void vastaanotaMoni(const uint8_t* paketti, int koko) {
+
+	/* Monilähetyksen paketit: palat, kierroksen lopussa tietopaketti,
+	   jonka jälkeen puuttuvat pyydetään, ja muiden vastaanottimien NACKit */
+
+	if (onNack(paketti, koko)) {
+		if (receiver_received_transmitter_address != receiver_transmitter_address && moni.siirto() >= 0)
+			moni.kuultuNack(lueNack(paketti, koko, (uint8_t)moni.siirto()));
+		return;
+	}
+	if (koko < HEADER_SIZE || koko < HEADER_SIZE + paketti[1]) {
+		jaljita(J2_VIRHEELLINEN_MONILAHETYS);
+		return;
+	}
+
+	uint8_t siirto = paketti[4];
+	int k = paketti[5] + 1;
+	if (siirto != moni.siirto()) {
+		// Uusi siirto, viiveet arvotaan vastaanottimen kohinasta
+		if (k > MONI_MAX_PALOJA) {
+			jaljita(J2_VIRHEELLINEN_MONILAHETYS);
+			return;
 		}
-		pc.printf("\n\r");
-		recv_offset = 0;		// Iteraattorin nollaus
+		moni.aloita(siirto, k, vastaanotin2.rx_entropy);
+		moni_kasitelty = false;
+		tiedot_saatu = false;
 	}
+	if (moni_kasitelty || k != moni.k())
+		return;
 
+	if (paketti[0] & HEADER_INFO_FLAG) {
+		if (!tiedot_saatu)
+			lueTietopaketti(paketti);
+		moni.kierrosLahetetty(monikello2.read_ms());
+	}
+	else {
+		moni.lisaa(lueU16(&paketti[2]), &paketti[HEADER_SIZE], paketti[1]);
+	}
+
+	if (!moni.valmis() || !tiedot_saatu)
+		return;
+
+	jaljita(J2_MONILAHETYS_SAATU, moni.nackeja(), moni.vaimennettuja());
+	for (int i = 0; i < moni.k(); i++) {
+		int alku = i * MONI_PALAN_KOKO;
+		int pala = (int)siirron_koko - alku;
+		if (pala > MONI_PALAN_KOKO)
+			pala = MONI_PALAN_KOKO;
+		if (pala > 0)
+			vastaanotaPala(alku, moni.pala(i), pala);
+	}
+	moni_kasitelty = true;
+	kuvaValmis();
 }
 
 /*********************************************************************
@@ -62,17 +462,23 @@ void luePaketti() {
 
 void tokaThreadFunction()
 {
-	while(!lahetin2.init(1000,D6,receiver_transmitter_address))
+	while(!lahetin2.init(BITTINOPEUS,D6,receiver_transmitter_address))
 	{
-		pc.printf("2: trasmitter2 initialization failed\r\n");
+		jaljita(J2_LAHETIN_ALUSTUS_EPAONNISTUI);
 	}
-	pc.printf("2: vastaanottimen lahetin2 alustettu\r\n");
+	jaljita(J2_LAHETIN_ALUSTETTU);
 	
-	while(!vastaanotin2.init(1000,D4,receiver_receiver_address))
+	while(!vastaanotin2.init(BITTINOPEUS,D4,receiver_receiver_address))
 	{
-		pc.printf("2: receiver2 initialization failed\r\n");
+		jaljita(J2_VASTAANOTIN_ALUSTUS_EPAONNISTUI);
 	}
-	pc.printf("2: vastaanottimen vastaanotin2 alustettu\r\n");
+	jaljita(J2_VASTAANOTIN_ALUSTETTU);
+
+	// Monilähetys tulee ryhmäosoitteeseen
+	vastaanotin2.rx_group_address = RYHMAOSOITE;
+	monikello2.start();
+
+	kokoaja.aloita(kirjoitaSiirto, 0);
 	
 	    
     while(true)
@@ -81,7 +487,12 @@ void tokaThreadFunction()
 		int koko = 0;
 		while(koko == 0)  // eli odotetaan kunnes viesti saadaan 
 		{
-			koko = vastaanotin2.recv(&buffer2,BUFFER_SIZE);
+			koko = vastaanotin2.recv(&receiver_received_receiver_address,&receiver_received_transmitter_address,&buffer2,BUFFER_SIZE);
+			// Kuittausviiveen aikana ei lähtenyt pakettia, johon kuittauksen olisi voinut liittää
+			if (koko == 0 && kuittaus_odottaa && kuittausviive2.read_ms() >= KUITTAUSVIIVE)
+				lahetaKuittaus();
+			if (koko == 0)
+				lahetaNack();
 		}
 
         /*
@@ -93,20 +504,104 @@ void tokaThreadFunction()
 
 
 
+		// Monilähetyksessä pyydetään vain puuttuvat
+		if (receiver_received_receiver_address == RYHMAOSOITE) {
+			vastaanotaMoni(buffer2, koko);
+			continue;
+		}
+
+		// Yleislähetystä ei kuitata
+		if (buffer2[0] & HEADER_FOUNTAIN_FLAG) {
+			jaljita(J2_DATA_VASTAANOTETTU);
+			printData(buffer2, koko);
+			vastaanotaSuihku(buffer2, koko);
+			continue;
+		}
+
+		// Tietopaketti kuitataan yksinään, datapaketit ryhmittäin.
+		// Kesken olevasta ryhmästä kerrotaan saadut paketit, kun lähetin
+		// pyytää kuittausta, jolloin se lähettää uudelleen vain puuttuvat.
+		bool kuitataan = true;
+		bool tietopaketti = buffer2[0] & HEADER_INFO_FLAG;
+		FecRyhma::Tulos tulos = FecRyhma::KESKEN;
+		if (tietopaketti) {
+			if (tietopakettiSaatu(buffer2))
+				tulos = FecRyhma::TOISTO;
+			else
+				ryhma.nollaa(buffer2[4]);
+		}
+		else {
+			tulos = ryhma.lisaa(buffer2, koko);
+			if (tulos == FecRyhma::VIRHE)
+				jaljita(J2_VIRHEELLINEN_RYHMA);
+		}
+
+		// Jo saatu paketti tarkoittaa, että kuittaus on kadonnut. Se
+		// kuitataan uudelleen heti (kesken olevassa ryhmässä, jos lähetin
+		// pyytää kuittausta), mutta sitä ei kopioida, tulosteta eikä
+		// käsitellä uudelleen, joten valmista kuvaa ei tulosteta toiseen kertaan.
+		if (tulos == FecRyhma::VANHA || tulos == FecRyhma::TOISTO) {
+			toistoja++;
+			if (tulos == FecRyhma::VANHA || tietopaketti || (buffer2[0] & HEADER_ACK_REQUEST_FLAG))
+				kuittaa(tietopaketti, ryhma.alku(), ryhma.saadut(), vastaanottoIkkuna(false));
+			continue;
+		}
+
 		// Tulostetaan vastaanotetun paketin data sarjamonitorille
-		pc.printf("2: vastaanotettu data:\n\r2: ");
+		jaljita(J2_DATA_VASTAANOTETTU);
 
-		printData(string((char *)&buffer2,koko)); // make a string by giving pointer to data and size of data	
-		                                          // and then deliver that string to printData function
-							
-		while(!lahetin2.send(receiver_target_receiver_address,&viesti2, sizeof(viesti2)))
-		{
-			pc.printf("2: trasmitter sending failed\r\n");
+		printData(buffer2, koko); // data kopioidaan lokirenkaaseen ja tulostetaan EventThreadilla
+
+		if (!tietopaketti)
+			kuitataan = tulos == FecRyhma::VALMIS ||
+				(tulos == FecRyhma::KESKEN && (buffer2[0] & HEADER_ACK_REQUEST_FLAG));
+
+		// Siirron viimeisen ryhmän jälkeen kuva tulostetaan, joten ikkuna
+		// suljetaan siksi aikaa ja avataan tulostuksen jälkeen
+		bool siirto_paattyy = false;
+		if (tulos == FecRyhma::VALMIS)
+			for (int i = 0; i < ryhma.paketteja(); i++)
+				if (ryhma.paketti(i)[0] & HEADER_LAST_FLAG)
+					siirto_paattyy = true;
+		tila_tulossa = siirto_paattyy;
+
+		if (kuitataan) {
+			// Valmis ryhmä käsitellään vasta kuittauksen jälkeen, mutta
+			// kuittaus kertoo jo seuraavan ryhmän alun
+			if (tulos == FecRyhma::VALMIS)
+				kuittaa(false, (uint8_t)(ryhma.alku() + ryhma.paketteja()), 0,
+					siirto_paattyy ? 0 : vastaanottoIkkuna(true));
+			else
+				kuittaa(tietopaketti, ryhma.alku(), ryhma.saadut(), vastaanottoIkkuna(tietopaketti));
 		}
 		
 		// kutsu vasta kuittausviestin jälkeen, jotta koko dataa tulostaessa ei tule 1. threadiltä
 		// "kuittauskello laukesi"-viestejä
-		luePaketti();
+		if (tietopaketti) {
+			lueTietopaketti(buffer2);
+		}
+		else if (tulos == FecRyhma::VALMIS) {
+			// Saadut paketit on jo annettu kokoajalle, pariteetilla korjatut
+			// annetaan nyt (kokoaja ohittaa jo saadut)
+			if (ryhma.korjattuja()) {
+				jaljita(J2_KORJATTU_PARITEETILLA, ryhma.korjattuja());
+				for (int i = 0; i < ryhma.paketteja(); i++)
+					luePaketti(ryhma.paketti(i));
+			}
+			else if (!(buffer2[0] & HEADER_PARITY_FLAG)) {
+				luePaketti(buffer2);
+			}
+			ryhma.seuraava();
+			if (siirto_paattyy) {
+				// Ikkunapäivitys kulkee tilapaketin perässä
+				kuittaa(false, ryhma.alku(), 0, vastaanottoIkkuna(true));
+				lahetaTila();
+			}
+		}
+		else if (tulos == FecRyhma::KESKEN && !(buffer2[0] & HEADER_PARITY_FLAG)) {
+			// Datapaketti käsitellään heti, vaikka ryhmä on vielä kesken
+			luePaketti(buffer2);
+		}
 
 		
 	}